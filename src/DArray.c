@@ -7,6 +7,7 @@
 
 #include <string.h>
 #include "DArray.h"
+#include "huge_alloc.h"
 
 static inline int default_cmp(const void *data1, const void *data2)
 {
@@ -26,6 +27,8 @@ DArray *DArray_create(size_t element_size, int initial_capacity, cmp_template cm
     array->capacity = initial_capacity;
     array->expand_rate = (uint16_t) DEFAULT_EXPAND_RATE;
     array->length = 0;
+    array->flags = 0;
+    array->huge_threshold = 0;
     array->cmp_func = cmp_func == NULL ? default_cmp : cmp_func;
 
     array->contents = calloc(initial_capacity, sizeof(void *));
@@ -40,6 +43,63 @@ error:
     return NULL;
 }
 
+int DArray_init_inline(DArray *array, void **storage, int capacity, cmp_template cmp_func)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(storage != NULL, "Somehow got storage that is NULL.");
+    check(capacity > 0, "Inline capacity should be positive.");
+
+    array->element_size = sizeof(void *);
+    array->capacity = capacity;
+    array->expand_rate = (uint16_t) DEFAULT_EXPAND_RATE;
+    array->length = 0;
+    array->flags = DARRAY_INLINE_CONTENTS | DARRAY_EMBEDDED;
+    array->huge_threshold = 0;
+    array->cmp_func = cmp_func == NULL ? default_cmp : cmp_func;
+    array->contents = storage;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// contents get freed through here so inline and huge page contents don't go to free()
+static inline void DArray_free_contents(DArray *array)
+{
+    if (array->flags & DARRAY_HUGE_CONTENTS) {
+        HugeAlloc_free(array->contents, (size_t) array->capacity * sizeof(void *));
+    } else if (!(array->flags & DARRAY_INLINE_CONTENTS)) {
+        free(array->contents);
+    }
+}
+
+// every DArray gets freed through here so embedded structs are left alone
+static inline void DArray_free_storage(DArray *array)
+{
+    DArray_free_contents(array);
+    if (!(array->flags & DARRAY_EMBEDDED)) {
+        free(array);
+    }
+}
+
+int DArray_release(DArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(array->flags & DARRAY_EMBEDDED, "Couldn't release array from DArray_create, use DArray_destroy.");
+
+    DArray_free_contents(array);
+    array->flags &= ~(DARRAY_INLINE_CONTENTS | DARRAY_HUGE_CONTENTS);
+    array->contents = NULL;
+    array->capacity = 0;
+    array->length = 0;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
 /* pushing and popping */
 
 int DArray_push(DArray *array, void *data)
@@ -70,7 +130,7 @@ void *DArray_pop(DArray *array)
     array->length--;
 
     // when contracted after expansion the minimum capacity stays DEFAULT_EXPAND_RATE
-    if (array->length <= array->capacity - array->expand_rate) {
+    if (array->capacity > array->expand_rate && array->length <= array->capacity - array->expand_rate) {
         int rc = DArray_contract(array);
         check(rc, "Couldn't contract array to new size, but you'll still be able to pop.");
     }
@@ -87,8 +147,32 @@ static inline int DArray_resize(DArray *array, size_t new_capacity)
 {
     check(new_capacity <= INT32_MAX, "Couldn't expand past max capacity %d AKA INT32_MAX", INT32_MAX);
 
-    void *contents = realloc(array->contents, new_capacity * sizeof(void *));
-    check_mem(contents);
+    size_t size = new_capacity * sizeof(void *);
+    int huge = array->huge_threshold && size >= array->huge_threshold;
+    void *contents = NULL;
+
+    if (huge && (array->flags & DARRAY_HUGE_CONTENTS)) {
+        contents = HugeAlloc_realloc(array->contents, (size_t) array->capacity * sizeof(void *), size);
+        check_mem(contents);
+    } else if (huge || (array->flags & (DARRAY_INLINE_CONTENTS | DARRAY_HUGE_CONTENTS))) {
+        // inline storage can't shrink or be realloc'ed, so we only leave it once it's too small
+        if (!huge && (array->flags & DARRAY_INLINE_CONTENTS) && new_capacity <= (size_t) array->capacity) {
+            return CERB_OK;
+        }
+
+        // contents move to another kind of storage
+        contents = huge ? HugeAlloc_alloc(size) : malloc(size);
+        check_mem(contents);
+        size_t keep = (size_t) array->length < new_capacity ? (size_t) array->length : new_capacity;
+        memcpy(contents, array->contents, keep * sizeof(void *));
+
+        DArray_free_contents(array);
+        array->flags &= ~(DARRAY_INLINE_CONTENTS | DARRAY_HUGE_CONTENTS);
+        array->flags |= huge ? DARRAY_HUGE_CONTENTS : 0;
+    } else {
+        contents = realloc(array->contents, size);
+        check_mem(contents);
+    }
 
     array->contents = contents;
     array->capacity = new_capacity;
@@ -142,6 +226,25 @@ error:
     return CERB_ERR;
 }
 
+int DArray_set_huge_threshold(DArray *array, size_t threshold)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    array->huge_threshold = threshold;
+
+    // nothing to move, and resizing to 0 would realloc contents away
+    if (array->capacity == 0) return CERB_OK;
+
+    // resizing to the same capacity moves contents to whatever storage the new threshold asks for
+    int rc = DArray_resize(array, (size_t) array->capacity);
+    check(rc != CERB_ERR, "Couldn't move contents, they stay where they were.");
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
 /* splitting and joining */
 
 int DArray_join(DArray **array1, DArray **array2)
@@ -155,15 +258,15 @@ int DArray_join(DArray **array1, DArray **array2)
     // then we expand and capacity is the exact amount needed to hold both array elements
     if ((*array1)->capacity < (*array1)->length + (*array2)->length) {
         int rc = DArray_resize(*array1, (size_t) ((*array1)->length + (*array2)->length));
-        check(rc, "Couldn't expand the array to fit new elements. arrays haven't been changed.");
+        check(rc != CERB_ERR, "Couldn't expand the array to fit new elements. arrays haven't been changed.");
     }
 
     memcpy((*array1)->contents + (*array1)->length, (*array2)->contents, sizeof(void *) * (*array2)->length);
-    
-    (*array1)->length = (*array1)->capacity;
 
-    free((*array2)->contents);
-    free(*array2);
+    // capacity can be bigger than both arrays together ( inline storage, or array1 had room already )
+    (*array1)->length += (*array2)->length;
+
+    DArray_free_storage(*array2);
     *array2 = NULL;
 
     return CERB_OK;
@@ -181,6 +284,7 @@ DArray *DArray_split(DArray **array, int from_position, int to_position)
     check(from_position < to_position, "Invalid positions.");
 
     int new_array_length = to_position - from_position;
+    int remaining = (*array)->length - new_array_length;
 
     DArray *new_array = DArray_create(8, new_array_length, (*array)->cmp_func);
     check(new_array != NULL, "Couldn't split the array.");
@@ -188,19 +292,18 @@ DArray *DArray_split(DArray **array, int from_position, int to_position)
 
     memcpy(new_array->contents, (*array)->contents + from_position, sizeof(void *) * new_array->length);
 
-    int i = 0, j = 0;
-    for (i = from_position; j < (*array)->length - to_position; i++, j++) {
-        (*array)->contents[i] = (*array)->contents[j + to_position];
-    }
+    memmove((*array)->contents + from_position, (*array)->contents + to_position,
+            sizeof(void *) * ((*array)->length - to_position));
 
-    int rc = DArray_resize(*array, (*array)->length - new_array_length);
-    if (!rc) {
+    // realloc to 0 would free contents, an emptied array keeps room for one element like setops results do
+    int rc = DArray_resize(*array, remaining ? remaining : 1);
+    if (rc == CERB_ERR) {
         log_err("Failed resize the array, thus it hasn't been splitted.");
-        free(new_array->contents);
-        free(new_array);
+        DArray_free_storage(new_array);
         goto error;
     }
-    (*array)->length = (*array)->capacity;
+    // inline storage doesn't shrink, so capacity isn't always what's left
+    (*array)->length = remaining;
     
     return new_array;
     
@@ -208,6 +311,94 @@ error:
     return NULL;
 }
 
+/* range operations */
+
+// make room for at least needed elements, growing by expand_rate past that like DArray_expand does
+static inline int DArray_reserve(DArray *array, int needed)
+{
+    if (needed <= array->capacity) return CERB_OK;
+
+    return DArray_resize(array, (size_t) needed + array->expand_rate);
+}
+
+int DArray_insert_range(DArray *array, int position, void **data, int count)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+    check(position >= 0 && position <= array->length, "Invalid position.");
+    check(count >= 0 && count <= INT32_MAX - array->length, "Invalid count.");
+
+    int rc = DArray_reserve(array, array->length + count);
+    check(rc != CERB_ERR, "Couldn't expand the array to fit new elements. array hasn't been changed.");
+
+    memmove(array->contents + position + count, array->contents + position,
+            sizeof(void *) * (array->length - position));
+    memcpy(array->contents + position, data, sizeof(void *) * count);
+    array->length += count;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int DArray_remove_range(DArray *array, int from_position, int to_position, void **removed)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(from_position >= 0 && from_position <= to_position, "Invalid from_position.");
+    check(to_position <= array->length, "Invalid to_position.");
+
+    if (removed) {
+        memcpy(removed, array->contents + from_position, sizeof(void *) * (to_position - from_position));
+    }
+
+    memmove(array->contents + from_position, array->contents + to_position,
+            sizeof(void *) * (array->length - to_position));
+    array->length -= to_position - from_position;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int DArray_compact(DArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    // skip to the first hole, everything before it stays where it is
+    int i = 0, j = 0;
+    while (i < array->length && array->contents[i]) i++;
+
+    for (j = i; j < array->length; j++) {
+        if (array->contents[j]) {
+            array->contents[i++] = array->contents[j];
+        }
+    }
+    array->length = i;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *DArray_swap_remove(DArray *array, int i)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(i < array->length, "Couldn't remove element number that hasn't been added to list previously.");
+    check(i >= 0, "Enter valid element position.");
+
+    void *data = array->contents[i];
+    array->contents[i] = array->contents[array->length - 1];
+    array->length--;
+
+    return data;
+
+error:
+    return NULL;
+}
+
 int DArray_set_expand_rate(DArray *array, uint16_t new_rate)
 {
     check(array != NULL, "Somehow got array that is NULL.");
@@ -227,8 +418,7 @@ int DArray_destroy(DArray **array)
     check(array != NULL, "Somehow got address of array that is NULL.");
     check(array != NULL, "Somehow got array that is NULL.");
 
-    free((*array)->contents);
-    free(*array);
+    DArray_free_storage(*array);
     *array = NULL;
 
     return CERB_OK;
@@ -277,8 +467,7 @@ int DArray_free_complex_data(DArray **array, free_func handler_func)
     for (i = 0; i < (*array)->length; i++) {
         handler_func((*array)->contents[i]);
     }
-    free((*array)->contents);
-    free(*array);
+    DArray_free_storage(*array);
 
     *array = NULL;
 
@@ -293,9 +482,7 @@ int DArray_free_array(DArray **array)
     check(array != NULL, "Somehow got address of array that is NULL.");
     check(*array != NULL, "Somehow got array that is NULL.");
 
-    free((*array)->contents);
-
-    free(*array);
+    DArray_free_storage(*array);
 
     *array = NULL;
 
@@ -363,12 +550,13 @@ int DArray_binary_search(DArray *array, void *search_data)
     check(search_data != NULL, "Couldn't search for NULL.");
 
     int low = 0, high = array->length - 1;
-    int middle = 0;
+    int middle = 0, cmp = 0;
     while (low <= high) {
         middle = (low + high) / 2;
-        if (array->cmp_func(array->contents[middle], search_data) < 0) {
+        cmp = array->cmp_func(array->contents[middle], search_data);
+        if (cmp < 0) {
             low = middle + 1;
-        } else if (array->cmp_func(array->contents[middle], search_data) > 0) {
+        } else if (cmp > 0) {
             high = middle - 1;
         } else {
             return middle;
@@ -378,4 +566,237 @@ int DArray_binary_search(DArray *array, void *search_data)
 
 error: // fall through
     return CERB_ERR;
+}
+
+/* scans over inline integer arrays */
+
+int DArray_find_int(DArray *array, intptr_t value)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+#if DARRAY_INT_KERNELS
+    return (int) Scan_find_u64((const uint64_t *) array->contents, (size_t) array->length, (uint64_t) value);
+#else
+    int i = 0;
+    for (i = 0; i < array->length; i++) {
+        if ((intptr_t) array->contents[i] == value) return i;
+    }
+
+    return CERB_ERR;
+#endif
+
+error:
+    return CERB_ERR;
+}
+
+int DArray_count_int(DArray *array, intptr_t value)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+#if DARRAY_INT_KERNELS
+    return (int) Scan_count_u64((const uint64_t *) array->contents, (size_t) array->length, (uint64_t) value);
+#else
+    int i = 0, count = 0;
+    for (i = 0; i < array->length; i++) {
+        count += (intptr_t) array->contents[i] == value;
+    }
+
+    return count;
+#endif
+
+error:
+    return CERB_ERR;
+}
+
+int DArray_min_int(DArray *array, intptr_t *out)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(out != NULL, "Somehow got out that is NULL.");
+    check(array->length > 0, "Couldn't get min of an empty array.");
+
+#if DARRAY_INT_KERNELS
+    *out = (intptr_t) Scan_min_i64((const int64_t *) array->contents, (size_t) array->length);
+#else
+    intptr_t min = (intptr_t) array->contents[0];
+    int i = 0;
+    for (i = 1; i < array->length; i++) {
+        intptr_t cur = (intptr_t) array->contents[i];
+        min = cur < min ? cur : min;
+    }
+    *out = min;
+#endif
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int DArray_max_int(DArray *array, intptr_t *out)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(out != NULL, "Somehow got out that is NULL.");
+    check(array->length > 0, "Couldn't get max of an empty array.");
+
+#if DARRAY_INT_KERNELS
+    *out = (intptr_t) Scan_max_i64((const int64_t *) array->contents, (size_t) array->length);
+#else
+    intptr_t max = (intptr_t) array->contents[0];
+    int i = 0;
+    for (i = 1; i < array->length; i++) {
+        intptr_t cur = (intptr_t) array->contents[i];
+        max = cur > max ? cur : max;
+    }
+    *out = max;
+#endif
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* eytzinger search index */
+
+// in-order walk over implicit tree puts sorted elements into their eytzinger slots
+static int eytzinger_fill(DArraySearchIndex *index, void **contents, int i, size_t k)
+{
+    if (k <= (size_t) index->length) {
+        i = eytzinger_fill(index, contents, i, 2 * k);
+        index->layout[k] = contents[i];
+        index->ranks[k] = i;
+        i++;
+        i = eytzinger_fill(index, contents, i, 2 * k + 1);
+    }
+
+    return i;
+}
+
+DArraySearchIndex *DArray_build_search_index(DArray *array)
+{
+    DArraySearchIndex *index = NULL;
+
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    index = calloc(1, sizeof(DArraySearchIndex));
+    check_mem(index);
+
+    index->length = array->length;
+    index->cmp_func = array->cmp_func;
+
+    // layout is cache line aligned so all descendants EYTZINGER_BLOCK levels below share one line
+    size_t layout_size = (size_t) (array->length + 1) * sizeof(void *);
+    layout_size = (layout_size + 63) & ~(size_t) 63;
+    index->layout = aligned_alloc(64, layout_size);
+    check_mem(index->layout);
+    index->ranks = malloc((size_t) (array->length + 1) * sizeof(int));
+    check_mem(index->ranks);
+
+    index->layout[0] = NULL;
+    index->ranks[0] = array->length;
+    eytzinger_fill(index, array->contents, 0, 1);
+
+    return index;
+
+error:
+    if (index) {
+        free(index->layout);
+        free(index->ranks);
+        free(index);
+    }
+    return NULL;
+}
+
+// descend without branching on the comparison, upper selects upper_bound instead of lower_bound
+static inline int eytzinger_search(DArraySearchIndex *index, void *search_data, int upper)
+{
+    void **layout = index->layout;
+    size_t length = (size_t) index->length;
+    size_t k = 1;
+
+    while (k <= length) {
+        __builtin_prefetch(layout + k * EYTZINGER_BLOCK);
+        int cmp = index->cmp_func(layout[k], search_data);
+        k = 2 * k + (upper ? cmp <= 0 : cmp < 0);
+    }
+    // undo the trailing right turns, what is left is the last node where we went left
+    k >>= __builtin_ffsl(~k);
+
+    return index->ranks[k];
+}
+
+int DArraySearchIndex_lower_bound(DArraySearchIndex *index, void *search_data)
+{
+    check(index != NULL, "Somehow got index that is NULL.");
+    check(search_data != NULL, "Couldn't search for NULL.");
+
+    return eytzinger_search(index, search_data, 0);
+
+error:
+    return CERB_ERR;
+}
+
+int DArraySearchIndex_upper_bound(DArraySearchIndex *index, void *search_data)
+{
+    check(index != NULL, "Somehow got index that is NULL.");
+    check(search_data != NULL, "Couldn't search for NULL.");
+
+    return eytzinger_search(index, search_data, 1);
+
+error:
+    return CERB_ERR;
+}
+
+int DArraySearchIndex_equal_range(DArraySearchIndex *index, void *search_data, int *from, int *to)
+{
+    check(index != NULL, "Somehow got index that is NULL.");
+    check(search_data != NULL, "Couldn't search for NULL.");
+    check(from != NULL && to != NULL, "Somehow got from or to that is NULL.");
+
+    *from = eytzinger_search(index, search_data, 0);
+    *to = eytzinger_search(index, search_data, 1);
+
+    return *to - *from;
+
+error:
+    return CERB_ERR;
+}
+
+void *DArraySearchIndex_find(DArraySearchIndex *index, void *search_data)
+{
+    check(index != NULL, "Somehow got index that is NULL.");
+    check(search_data != NULL, "Couldn't search for NULL.");
+
+    void **layout = index->layout;
+    size_t length = (size_t) index->length;
+    size_t k = 1;
+
+    while (k <= length) {
+        __builtin_prefetch(layout + k * EYTZINGER_BLOCK);
+        k = 2 * k + (index->cmp_func(layout[k], search_data) < 0);
+    }
+    k >>= __builtin_ffsl(~k);
+
+    if (k != 0 && index->cmp_func(layout[k], search_data) == 0) {
+        return layout[k];
+    }
+
+error: // fall through
+    return NULL;
+}
+
+int DArraySearchIndex_destroy(DArraySearchIndex **index)
+{
+    check(index != NULL, "Somehow got address of index that is NULL.");
+    check(*index != NULL, "Somehow got index that is NULL.");
+
+    free((*index)->layout);
+    free((*index)->ranks);
+    free(*index);
+    *index = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
 }
\ No newline at end of file
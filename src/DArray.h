@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "dbg.h"
+#include "scan.h"
 
 typedef void (*free_func) (void *data);
 typedef int (*cmp_template) (const void *data1, const void *data2);
@@ -23,13 +24,44 @@ typedef struct DArray {
     int length;
     size_t element_size;
     uint16_t expand_rate;
+    uint8_t flags; // DARRAY_INLINE_CONTENTS, DARRAY_EMBEDDED, DARRAY_HUGE_CONTENTS
+    size_t huge_threshold; // contents of at least this many bytes go to huge pages ( 0 means never )
     cmp_template cmp_func;
     void **contents;
 } DArray;
 
+// contents point to inline storage that isn't ours to free ( set until array grows past it )
+#define DARRAY_INLINE_CONTENTS 1
+// DArray struct itself lives in user memory ( stack, other struct ), it is never freed by us
+#define DARRAY_EMBEDDED 2
+// contents are a huge page region from HugeAlloc_alloc
+#define DARRAY_HUGE_CONTENTS 4
+
+// small array type with room for N elements inline, it allocates nothing until it grows past N
+// usable on the stack or inside other structs, but don't copy it around while contents are inline
+// DArray_small(8) tags; DArray_small_init(&tags, NULL); DArray_push(&tags.array, data); DArray_release(&tags.array);
+#define DArray_small(N) struct { DArray array; void *storage[N]; }
+// S is a pointer to DArray_small(N), after this use &(S)->array with any DArray function
+#define DArray_small_init(S, cmp_func)\
+        DArray_init_inline(&(S)->array, (S)->storage, (int) (sizeof((S)->storage) / sizeof(void *)), cmp_func)
+
+// read-only search index over a sorted DArray, elements are laid out in eytzinger ( BFS ) order
+// so the first levels of every search share few cache lines and next levels can be prefetched
+typedef struct DArraySearchIndex {
+    int length;
+    cmp_template cmp_func;
+    void **layout; // layout[1 .. length] in eytzinger order, layout[0] is unused
+    int *ranks; // ranks[k] is the position of layout[k] in the source array
+} DArraySearchIndex;
+
 // create a DArray. element size is 8, initial capacity could be any user specified number
 // cmp func is a function pointer and might be used to make sorted insertion or sort later and apply binary search
 DArray *DArray_create(size_t element_size, int initial_capacity, cmp_template cmp_func);
+// set up a DArray in user memory with capacity elements of storage, nothing gets allocated
+// until the array grows past capacity. use DArray_release ( not DArray_destroy ) on it when done
+int DArray_init_inline(DArray *array, void **storage, int capacity, cmp_template cmp_func);
+// free whatever DArray_init_inline'd array allocated after spilling to the heap, array is left empty
+int DArray_release(DArray *array);
 // expands DArray's capacity by DEFAULT_EXPAND_RATE
 int DArray_expand(DArray *array);
 // contracts DArray's capacity by DEFAULT EXPAND RATE
@@ -44,6 +76,18 @@ int DArray_shrink_to_fit(DArray *array);
 DArray *DArray_split(DArray **array, int from_position, int to_position);
 // join 2 arrays
 int DArray_join(DArray **array1, DArray **array2);
+// insert count elements from data at position, elements from position onwards move right
+int DArray_insert_range(DArray *array, int position, void **data, int count);
+// remove elements [ from_position, to_position ) and close the gap
+// if removed isn't NULL removed elements are copied there ( it should fit to_position - from_position of them )
+int DArray_remove_range(DArray *array, int from_position, int to_position, void **removed);
+// remove all NULL holes ( e.g. left by DArray_remove ) in one pass keeping order of the rest
+int DArray_compact(DArray *array);
+// remove element i in O(1) by moving the last element in its place ( order isn't kept ) and return it
+void *DArray_swap_remove(DArray *array, int i);
+// contents of threshold bytes or more get allocated 2 MB aligned on transparent huge pages ( 0 turns it off )
+// contents which are already there move right away if they cross the new threshold
+int DArray_set_huge_threshold(DArray *array, size_t threshold);
 // change DEFAULT EXPAND RATE
 int DArray_set_expand_rate(DArray *array, uint16_t new_rate);
 
@@ -61,6 +105,34 @@ int DArray_sorted_insert(DArray *array, void *data);
 // apply fast binary search ( SHOULD BE SORTED IF YOU USE )
 int DArray_binary_search(DArray *array, void *search_data);
 
+// build search index from array ( SHOULD BE SORTED IF YOU USE )
+// index copies element pointers, so array can change or be freed afterwards, but the data it points to can't
+DArraySearchIndex *DArray_build_search_index(DArray *array);
+// position of the first element which is not less than search_data ( index->length if there's none )
+int DArraySearchIndex_lower_bound(DArraySearchIndex *index, void *search_data);
+// position of the first element which is greater than search_data ( index->length if there's none )
+int DArraySearchIndex_upper_bound(DArraySearchIndex *index, void *search_data);
+// positions [ *from, *to ) of all elements equal to search_data, returns how many of them there are
+int DArraySearchIndex_equal_range(DArraySearchIndex *index, void *search_data, int *from, int *to);
+// return element equal to search_data or NULL if there's none
+void *DArraySearchIndex_find(DArraySearchIndex *index, void *search_data);
+// free the index ( pass a reference to make it NULL after freeing )
+int DArraySearchIndex_destroy(DArraySearchIndex **index);
+
+// contents go straight to the 64 bit scan kernels only when pointers are 64 bits, otherwise plain loops are used
+#ifndef DARRAY_INT_KERNELS
+#define DARRAY_INT_KERNELS (UINTPTR_MAX == UINT64_MAX)
+#endif
+
+// these work on arrays which keep integers right in contents ( pushed as (void *) (intptr_t) value )
+// position of the first element equal to value or CERB_ERR if there's none
+int DArray_find_int(DArray *array, intptr_t value);
+// how many elements are equal to value
+int DArray_count_int(DArray *array, intptr_t value);
+// write the smallest / largest element to *out ( array shouldn't be empty )
+int DArray_min_int(DArray *array, intptr_t *out);
+int DArray_max_int(DArray *array, intptr_t *out);
+
 // free complex, user created data structures: structs, unions ...
 // handler_func is a function you provide for handling (freeing) your own data structures
 int DArray_free_complex_data(DArray **array, free_func handler_func);
@@ -90,13 +162,17 @@ static inline int DArray_get_pos(DArray *array, void *search_data)
     check(array != NULL, "Somehow got array that is NULL.");
     check(search_data != NULL, "Somehow got search_data that is NULL.");
 
+#if DARRAY_INT_KERNELS
+    return (int) Scan_find_u64((const uint64_t *) array->contents, (size_t) array->length, (uint64_t) (uintptr_t) search_data);
+#else
     int i = 0;
     for (i = 0; i < array->length; i++) {
-        if (array->contents[i] == search_data) {
-            return i;
-        }
+        if (array->contents[i] == search_data) return i;
     }
 
+    return CERB_ERR;
+#endif
+
 error:
     return CERB_ERR;
 }
@@ -154,4 +230,7 @@ error:
 
 #define DEFAULT_EXPAND_RATE 300
 
+// how many layout entries fit in a cache line, search prefetches that many levels ahead
+#define EYTZINGER_BLOCK (64 / sizeof(void *))
+
 #endif /* FE64FB78_C357_4BF2_988D_468BA50B4D80 */
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "DArray_parallel.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// chunks per thread, more chunks balance uneven elements better but cost more claims
+#define PARALLEL_CHUNKS_PER_THREAD 16
+#define PARALLEL_MAX_GRAIN 4096
+
+typedef struct ParallelJob ParallelJob;
+typedef void (*chunk_func) (ParallelJob *job, int chunk, int from, int to);
+
+struct ParallelJob {
+    DArray *array;
+    int grain;
+    int chunk_count;
+    atomic_int next_chunk;
+    chunk_func run_chunk;
+    DArray_for_func for_func;
+    DArray_reduce_func reduce;
+    DArray_filter_func keep;
+    void *identity;
+    void *ctx;
+    void **partials; // reduce: one result per chunk
+    uint8_t *kept; // filter: keep flag per element
+    int *offsets; // filter: kept elements per chunk, then where each chunk writes
+    DArray *result;
+};
+
+/* pool */
+
+// shared scheduler, calls hold lock for reading while they use it and pool settings take it for writing
+static struct {
+    pthread_rwlock_t lock;
+    pthread_mutex_t start_lock;
+    Scheduler *scheduler;
+    atomic_int wanted; // threads asked for by DArray_parallel_set_threads, 0 is one per CPU ( read without lock )
+} pool = {
+    .lock = PTHREAD_RWLOCK_INITIALIZER,
+    .start_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// non zero while this thread holds lock for a call or runs chunks of one, pool settings taking
+// lock for writing from in there would wait for the call they're part of
+static _Thread_local int pool_depth = 0;
+
+static int pool_threads(void)
+{
+    int wanted = atomic_load_explicit(&pool.wanted, memory_order_relaxed);
+    if (wanted > 0) return wanted;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int) cpus : 1;
+}
+
+// call with lock held for reading, the caller is one of the threads so one less worker gets started
+static Scheduler *pool_scheduler(void)
+{
+    pthread_mutex_lock(&pool.start_lock);
+    if (!pool.scheduler) {
+        pool.scheduler = Scheduler_create(pool_threads() - 1);
+    }
+    pthread_mutex_unlock(&pool.start_lock);
+
+    return pool.scheduler;
+}
+
+static void ParallelJob_work(ParallelJob *job)
+{
+    pool_depth++;
+
+    int chunk = 0;
+    while ((chunk = atomic_fetch_add_explicit(&job->next_chunk, 1, memory_order_relaxed)) < job->chunk_count) {
+        int from = chunk * job->grain;
+        int to = from + job->grain < job->array->length ? from + job->grain : job->array->length;
+        job->run_chunk(job, chunk, from, to);
+    }
+
+    pool_depth--;
+}
+
+static void ParallelJob_task(void *job)
+{
+    ParallelJob_work(job);
+}
+
+static int ParallelJob_run(ParallelJob *job)
+{
+    if (job->chunk_count == 0) return CERB_OK;
+
+    // single chunks aren't worth waking anybody for
+    if (job->chunk_count == 1) {
+        ParallelJob_work(job);
+        return CERB_OK;
+    }
+
+    pthread_rwlock_rdlock(&pool.lock);
+    pool_depth++;
+
+    Scheduler *scheduler = pool_scheduler();
+    check(scheduler != NULL, "Couldn't start worker threads.");
+
+    // helpers claim chunks like the caller does, calls from inside chunks spawn into their worker's deque
+    // and wait by running other tasks, so nested parallel calls spread out instead of running serially
+    TaskGroup group;
+    TaskGroup_init(&group);
+
+    int helpers = scheduler->thread_count < job->chunk_count - 1 ? scheduler->thread_count : job->chunk_count - 1;
+    int i = 0;
+    for (i = 0; i < helpers; i++) {
+        // chunks don't belong to anybody, whatever a missing helper would do the others do
+        if (Scheduler_spawn(scheduler, &group, ParallelJob_task, job) == CERB_ERR) break;
+    }
+
+    ParallelJob_work(job);
+    Scheduler_wait(scheduler, &group);
+
+    pool_depth--;
+    pthread_rwlock_unlock(&pool.lock);
+
+    return CERB_OK;
+
+error:
+    pool_depth--;
+    pthread_rwlock_unlock(&pool.lock);
+    return CERB_ERR;
+}
+
+static void ParallelJob_init(ParallelJob *job, DArray *array, chunk_func run_chunk, void *ctx)
+{
+    int grain = array->length / (pool_threads() * PARALLEL_CHUNKS_PER_THREAD);
+
+    job->array = array;
+    job->grain = grain < 1 ? 1 : grain > PARALLEL_MAX_GRAIN ? PARALLEL_MAX_GRAIN : grain;
+    job->chunk_count = (array->length + job->grain - 1) / job->grain;
+    atomic_init(&job->next_chunk, 0);
+    job->run_chunk = run_chunk;
+    job->for_func = NULL;
+    job->reduce = NULL;
+    job->keep = NULL;
+    job->ctx = ctx;
+    job->identity = NULL;
+    job->partials = NULL;
+    job->kept = NULL;
+    job->offsets = NULL;
+    job->result = NULL;
+}
+
+// a job can be run again once its chunks are all claimed
+static inline void ParallelJob_rewind(ParallelJob *job, chunk_func run_chunk)
+{
+    atomic_store_explicit(&job->next_chunk, 0, memory_order_relaxed);
+    job->run_chunk = run_chunk;
+}
+
+/* parallel for */
+
+static void for_chunk(ParallelJob *job, int chunk, int from, int to)
+{
+    (void) chunk;
+
+    int i = 0;
+    for (i = from; i < to; i++) {
+        job->for_func(job->array->contents[i], i, job->ctx);
+    }
+}
+
+int DArray_parallel_for(DArray *array, DArray_for_func func, void *ctx)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(func != NULL, "Somehow got func (callback) that is NULL.");
+
+    ParallelJob job;
+    ParallelJob_init(&job, array, for_chunk, ctx);
+    job.for_func = func;
+
+    return ParallelJob_run(&job);
+
+error:
+    return CERB_ERR;
+}
+
+/* parallel reduce */
+
+static void reduce_chunk(ParallelJob *job, int chunk, int from, int to)
+{
+    void *accumulator = job->identity;
+
+    int i = 0;
+    for (i = from; i < to; i++) {
+        accumulator = job->reduce(accumulator, job->array->contents[i], job->ctx);
+    }
+    job->partials[chunk] = accumulator;
+}
+
+void *DArray_parallel_reduce(DArray *array, void *identity, DArray_reduce_func reduce,
+        DArray_combine_func combine, void *ctx)
+{
+    ParallelJob job;
+    job.partials = NULL;
+
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(reduce != NULL, "Somehow got reduce (callback) that is NULL.");
+    check(combine != NULL, "Somehow got combine (callback) that is NULL.");
+
+    ParallelJob_init(&job, array, reduce_chunk, ctx);
+    job.reduce = reduce;
+    job.identity = identity;
+
+    if (job.chunk_count == 0) return identity;
+
+    job.partials = malloc(sizeof(void *) * job.chunk_count);
+    check_mem(job.partials);
+
+    int rc = ParallelJob_run(&job);
+    check(rc != CERB_ERR, "Couldn't reduce the array.");
+
+    void *result = job.partials[0];
+    int i = 0;
+    for (i = 1; i < job.chunk_count; i++) {
+        result = combine(result, job.partials[i], ctx);
+    }
+    free(job.partials);
+
+    return result;
+
+error:
+    free(job.partials);
+    return NULL;
+}
+
+/* parallel filter */
+
+// first pass flags elements and counts them per chunk
+static void filter_mark_chunk(ParallelJob *job, int chunk, int from, int to)
+{
+    int count = 0;
+
+    int i = 0;
+    for (i = from; i < to; i++) {
+        job->kept[i] = job->keep(job->array->contents[i], job->ctx) != 0;
+        count += job->kept[i];
+    }
+    job->offsets[chunk] = count;
+}
+
+// second pass copies kept elements to where the chunk's prefix sum says
+static void filter_copy_chunk(ParallelJob *job, int chunk, int from, int to)
+{
+    void **out = job->result->contents + job->offsets[chunk];
+
+    int i = 0;
+    for (i = from; i < to; i++) {
+        if (job->kept[i]) *out++ = job->array->contents[i];
+    }
+}
+
+DArray *DArray_parallel_filter(DArray *array, DArray_filter_func keep, void *ctx)
+{
+    ParallelJob job;
+    job.kept = NULL;
+    job.offsets = NULL;
+    job.result = NULL;
+
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(keep != NULL, "Somehow got keep (callback) that is NULL.");
+
+    ParallelJob_init(&job, array, filter_mark_chunk, ctx);
+    job.keep = keep;
+
+    job.kept = malloc(array->length + 1);
+    check_mem(job.kept);
+    job.offsets = malloc(sizeof(int) * (job.chunk_count + 1));
+    check_mem(job.offsets);
+
+    int rc = ParallelJob_run(&job);
+    check(rc != CERB_ERR, "Couldn't filter the array.");
+
+    int i = 0, total = 0;
+    for (i = 0; i < job.chunk_count; i++) {
+        int count = job.offsets[i];
+        job.offsets[i] = total;
+        total += count;
+    }
+
+    job.result = DArray_create(sizeof(void *), total, array->cmp_func);
+    check(job.result != NULL, "Couldn't create filtered array.");
+    job.result->length = total;
+
+    ParallelJob_rewind(&job, filter_copy_chunk);
+    rc = ParallelJob_run(&job);
+    check(rc != CERB_ERR, "Couldn't filter the array.");
+
+    free(job.kept);
+    free(job.offsets);
+
+    return job.result;
+
+error:
+    free(job.kept);
+    free(job.offsets);
+    if (job.result) DArray_destroy(&job.result);
+    return NULL;
+}
+
+/* pool settings */
+
+Scheduler *DArray_parallel_scheduler(void)
+{
+    pthread_rwlock_rdlock(&pool.lock);
+    Scheduler *scheduler = pool_scheduler();
+    pthread_rwlock_unlock(&pool.lock);
+
+    return scheduler;
+}
+
+int DArray_parallel_set_threads(int threads)
+{
+    check(threads >= 0, "Thread count can't be negative.");
+    check(pool_depth == 0, "Couldn't change threads from inside a parallel call.");
+
+    pthread_rwlock_wrlock(&pool.lock);
+    if (pool.scheduler) Scheduler_destroy(&pool.scheduler);
+    atomic_store_explicit(&pool.wanted, threads, memory_order_relaxed);
+    pthread_rwlock_unlock(&pool.lock);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int DArray_parallel_shutdown(void)
+{
+    check(pool_depth == 0, "Couldn't stop threads from inside a parallel call.");
+
+    pthread_rwlock_wrlock(&pool.lock);
+    if (pool.scheduler) Scheduler_destroy(&pool.scheduler);
+    pthread_rwlock_unlock(&pool.lock);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,36 @@
+#ifndef F2DF8EE9_C860_46F2_9446_DCF2F15A1C10
+#define F2DF8EE9_C860_46F2_9446_DCF2F15A1C10
+
+#include "DArray.h"
+#include "scheduler.h"
+
+// index range of an array is cut into chunks which a pool of worker threads ( and the caller )
+// claim one at a time, so cheap and expensive elements even out across threads
+// the pool is a Scheduler which starts on first use with one thread per CPU and is reused by every call
+// calls from inside func spread over the pool too, a thread waiting for its chunks runs other tasks meanwhile
+
+typedef void (*DArray_for_func) (void *element, int i, void *ctx);
+typedef void *(*DArray_reduce_func) (void *accumulator, void *element, void *ctx);
+typedef void *(*DArray_combine_func) (void *left, void *right, void *ctx);
+typedef int (*DArray_filter_func) (void *element, void *ctx);
+
+// call func(element, i, ctx) for every element, in no particular order
+int DArray_parallel_for(DArray *array, DArray_for_func func, void *ctx);
+// every chunk folds its elements into identity with reduce, then chunk results are
+// folded left to right with combine ( so combine only has to be associative )
+void *DArray_parallel_reduce(DArray *array, void *identity, DArray_reduce_func reduce,
+        DArray_combine_func combine, void *ctx);
+// new array with elements for which keep returns non zero, in their original order
+DArray *DArray_parallel_filter(DArray *array, DArray_filter_func keep, void *ctx);
+
+// the pool's scheduler, so other parallel code ( e.g. recursive sorts or hashmap rebuilds ) can share its threads
+// it stays valid until DArray_parallel_set_threads or DArray_parallel_shutdown
+Scheduler *DArray_parallel_scheduler(void);
+// use threads threads ( caller included ) from now on, 0 means one per CPU
+// these two wait for running calls to finish, so from inside func they return CERB_ERR instead of deadlocking
+// ( tasks you spawn on DArray_parallel_scheduler yourself shouldn't call them either, nothing catches that )
+int DArray_parallel_set_threads(int threads);
+// stop worker threads, next parallel call starts them again
+int DArray_parallel_shutdown(void);
+
+#endif /* F2DF8EE9_C860_46F2_9446_DCF2F15A1C10 */
@@ -0,0 +1,355 @@
+#include "DArray_setops.h"
+#include "scan.h"
+#include <string.h>
+
+static inline DArray *setops_result(DArray *like, int capacity)
+{
+    return DArray_create(sizeof(void *), capacity > 0 ? capacity : 1, like->cmp_func);
+}
+
+static inline void setops_copy(DArray *out, void **from, int count)
+{
+    memcpy(out->contents + out->length, from, sizeof(void *) * count);
+    out->length += count;
+}
+
+static inline int setops_skewed(DArray *array1, DArray *array2)
+{
+    return (long) array1->length * SETOPS_GALLOP_RATIO < array2->length
+        || (long) array2->length * SETOPS_GALLOP_RATIO < array1->length;
+}
+
+// first position from from onwards whose element isn't less than key
+// steps 1, 2, 4 ... past from until it overshoots, then binary searches the last step
+static inline int gallop(DArray *array, int from, void *key, cmp_template cmp)
+{
+    void **contents = array->contents;
+    int length = array->length;
+
+    if (from >= length || cmp(contents[from], key) >= 0) return from;
+
+    int low = from, step = 1;
+    while (low + step < length && cmp(contents[low + step], key) < 0) {
+        low += step;
+        step <<= 1;
+    }
+
+    int high = low + step < length ? low + step : length;
+    low++;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (cmp(contents[middle], key) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/* intersection */
+
+DArray *DArray_sorted_intersect(DArray *array1, DArray *array2)
+{
+    check(array1 != NULL, "Somehow got array1 that is NULL.");
+    check(array2 != NULL, "Somehow got array2 that is NULL.");
+
+    cmp_template cmp = array1->cmp_func;
+    DArray *out = setops_result(array1, array1->length < array2->length ? array1->length : array2->length);
+    check(out != NULL, "Couldn't create result array.");
+
+    int i = 0, j = 0;
+
+    if (setops_skewed(array1, array2)) {
+        int first_is_small = array1->length < array2->length;
+        DArray *small = first_is_small ? array1 : array2;
+        DArray *large = first_is_small ? array2 : array1;
+
+        for (i = 0; i < small->length && j < large->length; i++) {
+            j = gallop(large, j, small->contents[i], cmp);
+            if (j < large->length && cmp(large->contents[j], small->contents[i]) == 0) {
+                out->contents[out->length++] = first_is_small ? small->contents[i] : large->contents[j];
+                j++;
+            }
+        }
+    } else {
+        while (i < array1->length && j < array2->length) {
+            int c = cmp(array1->contents[i], array2->contents[j]);
+            if (c == 0) out->contents[out->length++] = array1->contents[i];
+            i += c <= 0;
+            j += c >= 0;
+        }
+    }
+
+    return out;
+
+error:
+    return NULL;
+}
+
+/* union */
+
+DArray *DArray_sorted_union(DArray *array1, DArray *array2)
+{
+    check(array1 != NULL, "Somehow got array1 that is NULL.");
+    check(array2 != NULL, "Somehow got array2 that is NULL.");
+    check(array1->length <= INT32_MAX - array2->length, "Union would be longer than INT32_MAX.");
+
+    cmp_template cmp = array1->cmp_func;
+    DArray *out = setops_result(array1, array1->length + array2->length);
+    check(out != NULL, "Couldn't create result array.");
+
+    int i = 0, j = 0;
+
+    if (setops_skewed(array1, array2)) {
+        int first_is_small = array1->length < array2->length;
+        DArray *small = first_is_small ? array1 : array2;
+        DArray *large = first_is_small ? array2 : array1;
+        int s = 0, l = 0;
+
+        // everything in large up to the next small element goes over in one copy
+        for (s = 0; s < small->length; s++) {
+            int found = gallop(large, l, small->contents[s], cmp);
+            setops_copy(out, large->contents + l, found - l);
+            l = found;
+
+            if (l < large->length && cmp(large->contents[l], small->contents[s]) == 0) {
+                out->contents[out->length++] = first_is_small ? small->contents[s] : large->contents[l];
+                l++;
+            } else {
+                out->contents[out->length++] = small->contents[s];
+            }
+        }
+        setops_copy(out, large->contents + l, large->length - l);
+    } else {
+        while (i < array1->length && j < array2->length) {
+            int c = cmp(array1->contents[i], array2->contents[j]);
+            out->contents[out->length++] = c <= 0 ? array1->contents[i] : array2->contents[j];
+            i += c <= 0;
+            j += c >= 0;
+        }
+        setops_copy(out, array1->contents + i, array1->length - i);
+        setops_copy(out, array2->contents + j, array2->length - j);
+    }
+
+    return out;
+
+error:
+    return NULL;
+}
+
+/* difference */
+
+DArray *DArray_sorted_difference(DArray *array1, DArray *array2)
+{
+    check(array1 != NULL, "Somehow got array1 that is NULL.");
+    check(array2 != NULL, "Somehow got array2 that is NULL.");
+
+    cmp_template cmp = array1->cmp_func;
+    DArray *out = setops_result(array1, array1->length);
+    check(out != NULL, "Couldn't create result array.");
+
+    int i = 0, j = 0;
+
+    if (setops_skewed(array1, array2) && array2->length < array1->length) {
+        // few elements to take out, runs of array1 between them go over in one copy
+        for (j = 0; j < array2->length && i < array1->length; j++) {
+            int found = gallop(array1, i, array2->contents[j], cmp);
+            setops_copy(out, array1->contents + i, found - i);
+            i = found;
+            if (i < array1->length && cmp(array1->contents[i], array2->contents[j]) == 0) i++;
+        }
+        setops_copy(out, array1->contents + i, array1->length - i);
+    } else if (setops_skewed(array1, array2)) {
+        // few elements to keep, each one looks itself up in array2
+        for (i = 0; i < array1->length; i++) {
+            j = gallop(array2, j, array1->contents[i], cmp);
+            if (j < array2->length && cmp(array2->contents[j], array1->contents[i]) == 0) {
+                j++;
+            } else {
+                out->contents[out->length++] = array1->contents[i];
+            }
+        }
+    } else {
+        while (i < array1->length && j < array2->length) {
+            int c = cmp(array1->contents[i], array2->contents[j]);
+            if (c < 0) out->contents[out->length++] = array1->contents[i];
+            i += c <= 0;
+            j += c >= 0;
+        }
+        setops_copy(out, array1->contents + i, array1->length - i);
+    }
+
+    return out;
+
+error:
+    return NULL;
+}
+
+/* k way merge */
+
+// min heap of array numbers ordered by their current element, ties go to the lower array number
+static inline int merge_less(DArray **arrays, int *positions, int a, int b, cmp_template cmp)
+{
+    int c = cmp(arrays[a]->contents[positions[a]], arrays[b]->contents[positions[b]]);
+    return c < 0 || (c == 0 && a < b);
+}
+
+static void merge_sift_down(DArray **arrays, int *positions, int *heap, int heap_size, int i, cmp_template cmp)
+{
+    for (;;) {
+        int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < heap_size && merge_less(arrays, positions, heap[left], heap[smallest], cmp)) smallest = left;
+        if (right < heap_size && merge_less(arrays, positions, heap[right], heap[smallest], cmp)) smallest = right;
+        if (smallest == i) break;
+
+        int temp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = temp;
+        i = smallest;
+    }
+}
+
+DArray *DArray_sorted_merge_k(DArray **arrays, int count)
+{
+    int *heap = NULL;
+    int *positions = NULL;
+    DArray *out = NULL;
+
+    check(arrays != NULL, "Somehow got arrays that is NULL.");
+    check(count > 0, "Couldn't merge less than one array.");
+
+    long total = 0;
+    int i = 0, heap_size = 0;
+    for (i = 0; i < count; i++) {
+        check(arrays[i] != NULL, "Somehow got array %d that is NULL.", i);
+        total += arrays[i]->length;
+    }
+    check(total <= INT32_MAX, "Merged array would be longer than INT32_MAX.");
+
+    cmp_template cmp = arrays[0]->cmp_func;
+    out = setops_result(arrays[0], (int) total);
+    check(out != NULL, "Couldn't create result array.");
+
+    heap = malloc(sizeof(int) * count);
+    check_mem(heap);
+    positions = calloc(count, sizeof(int));
+    check_mem(positions);
+
+    for (i = 0; i < count; i++) {
+        if (arrays[i]->length) heap[heap_size++] = i;
+    }
+    for (i = heap_size / 2 - 1; i >= 0; i--) {
+        merge_sift_down(arrays, positions, heap, heap_size, i, cmp);
+    }
+
+    while (heap_size) {
+        int top = heap[0];
+        out->contents[out->length++] = arrays[top]->contents[positions[top]++];
+
+        if (positions[top] == arrays[top]->length) {
+            heap[0] = heap[--heap_size];
+        }
+        merge_sift_down(arrays, positions, heap, heap_size, 0, cmp);
+    }
+
+    free(heap);
+    free(positions);
+
+    return out;
+
+error:
+    free(heap);
+    free(positions);
+    if (out) DArray_destroy(&out);
+    return NULL;
+}
+
+/* inline integer versions */
+
+DArray *DArray_sorted_intersect_int(DArray *array1, DArray *array2)
+{
+    check(array1 != NULL, "Somehow got array1 that is NULL.");
+    check(array2 != NULL, "Somehow got array2 that is NULL.");
+
+    DArray *out = setops_result(array1, array1->length < array2->length ? array1->length : array2->length);
+    check(out != NULL, "Couldn't create result array.");
+
+#if DARRAY_INT_KERNELS
+    out->length = (int) Scan_intersect_i64((const int64_t *) array1->contents, (size_t) array1->length,
+            (const int64_t *) array2->contents, (size_t) array2->length, (int64_t *) out->contents);
+#else
+    void **a = array1->contents, **b = array2->contents, **o = out->contents;
+    int i = 0, j = 0, k = 0;
+
+    while (i < array1->length && j < array2->length) {
+        intptr_t x = (intptr_t) a[i], y = (intptr_t) b[j];
+        o[k] = a[i];
+        k += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    out->length = k;
+#endif
+
+    return out;
+
+error:
+    return NULL;
+}
+
+DArray *DArray_sorted_union_int(DArray *array1, DArray *array2)
+{
+    check(array1 != NULL, "Somehow got array1 that is NULL.");
+    check(array2 != NULL, "Somehow got array2 that is NULL.");
+    check(array1->length <= INT32_MAX - array2->length, "Union would be longer than INT32_MAX.");
+
+    DArray *out = setops_result(array1, array1->length + array2->length);
+    check(out != NULL, "Couldn't create result array.");
+
+    void **a = array1->contents, **b = array2->contents, **o = out->contents;
+    int i = 0, j = 0, k = 0;
+
+    while (i < array1->length && j < array2->length) {
+        intptr_t x = (intptr_t) a[i], y = (intptr_t) b[j];
+        o[k++] = x <= y ? a[i] : b[j];
+        i += x <= y;
+        j += y <= x;
+    }
+    out->length = k;
+    setops_copy(out, array1->contents + i, array1->length - i);
+    setops_copy(out, array2->contents + j, array2->length - j);
+
+    return out;
+
+error:
+    return NULL;
+}
+
+DArray *DArray_sorted_difference_int(DArray *array1, DArray *array2)
+{
+    check(array1 != NULL, "Somehow got array1 that is NULL.");
+    check(array2 != NULL, "Somehow got array2 that is NULL.");
+
+    DArray *out = setops_result(array1, array1->length);
+    check(out != NULL, "Couldn't create result array.");
+
+    void **a = array1->contents, **b = array2->contents, **o = out->contents;
+    int i = 0, j = 0, k = 0;
+
+    while (i < array1->length && j < array2->length) {
+        intptr_t x = (intptr_t) a[i], y = (intptr_t) b[j];
+        o[k] = a[i];
+        k += x < y;
+        i += x <= y;
+        j += y <= x;
+    }
+    out->length = k;
+    setops_copy(out, array1->contents + i, array1->length - i);
+
+    return out;
+
+error:
+    return NULL;
+}
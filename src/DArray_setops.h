@@ -0,0 +1,29 @@
+#ifndef EA5C4B25_5057_4C84_A81E_C08F39FA4093
+#define EA5C4B25_5057_4C84_A81E_C08F39FA4093
+
+#include "DArray.h"
+
+// set operations on arrays sorted by cmp_func ( SHOULD BE SORTED IF YOU USE ), results are new sorted arrays
+// array1's cmp_func is used and when both arrays have an equal element the one from array1 is kept
+// when one array is many times smaller we walk it and gallop ( exponential search ) through the other one,
+// so intersecting 10 ids with 10 million costs about 10 * log(1000000) comparisons
+
+// skewed if one array is this many times longer than the other
+#define SETOPS_GALLOP_RATIO 16
+
+// elements which are in both arrays
+DArray *DArray_sorted_intersect(DArray *array1, DArray *array2);
+// elements which are in either array
+DArray *DArray_sorted_union(DArray *array1, DArray *array2);
+// elements of array1 which aren't in array2
+DArray *DArray_sorted_difference(DArray *array1, DArray *array2);
+// merge count sorted arrays into one ( duplicates are kept, equal elements keep order of arrays they came from )
+DArray *DArray_sorted_merge_k(DArray **arrays, int count);
+
+// same for arrays which keep integers right in contents ( pushed as (void *) (intptr_t) value )
+// sorted ascending and without duplicates, these don't call cmp_func at all
+DArray *DArray_sorted_intersect_int(DArray *array1, DArray *array2);
+DArray *DArray_sorted_union_int(DArray *array1, DArray *array2);
+DArray *DArray_sorted_difference_int(DArray *array1, DArray *array2);
+
+#endif /* EA5C4B25_5057_4C84_A81E_C08F39FA4093 */
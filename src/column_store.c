@@ -0,0 +1,210 @@
+#include "column_store.h"
+#include <stdlib.h>
+#include <string.h>
+
+static inline size_t column_bytes(size_t field_size, int capacity)
+{
+    size_t bytes = field_size * (size_t) capacity;
+
+    // aligned_alloc wants a multiple of the alignment
+    return (bytes + COLUMN_STORE_ALIGN - 1) & ~(size_t) (COLUMN_STORE_ALIGN - 1);
+}
+
+// fields of the common sizes get copied with one load and store instead of a memcpy call
+static inline void copy_field(uint8_t *to, const uint8_t *from, size_t size)
+{
+    switch (size) {
+        case 1: *to = *from; break;
+        case 2: memcpy(to, from, 2); break;
+        case 4: memcpy(to, from, 4); break;
+        case 8: memcpy(to, from, 8); break;
+        default: memcpy(to, from, size);
+    }
+}
+
+ColumnStore *ColumnStore_create(const ColumnField *fields, int field_count, size_t row_size, int initial_capacity)
+{
+    ColumnStore *store = NULL;
+
+    check(fields != NULL, "Somehow got fields that are NULL.");
+    check(field_count > 0, "Store needs at least one field.");
+    check(initial_capacity >= 0, "Initial capacity can't be negative.");
+
+    int f = 0;
+    for (f = 0; f < field_count; f++) {
+        check(fields[f].size > 0, "Field %d has no size.", f);
+        check(fields[f].offset + fields[f].size <= row_size, "Field %d doesn't fit in the row.", f);
+    }
+
+    store = calloc(1, sizeof(ColumnStore));
+    check_mem(store);
+
+    store->field_count = field_count;
+    store->row_size = row_size;
+
+    store->fields = malloc(sizeof(ColumnField) * field_count);
+    check_mem(store->fields);
+    memcpy(store->fields, fields, sizeof(ColumnField) * field_count);
+
+    store->columns = calloc(field_count, sizeof(uint8_t *));
+    check_mem(store->columns);
+
+    int rc = ColumnStore_reserve(store, initial_capacity > 0 ? initial_capacity : 1);
+    check(rc != CERB_ERR, "Couldn't allocate columns.");
+
+    return store;
+
+error:
+    ColumnStore_destroy(&store);
+    return NULL;
+}
+
+int ColumnStore_reserve(ColumnStore *store, int capacity)
+{
+    uint8_t **columns = NULL;
+
+    check(store != NULL, "Somehow got store that is NULL.");
+    check(capacity >= 0, "Capacity can't be negative.");
+
+    if (capacity <= store->capacity) return CERB_OK;
+
+    // every column is allocated before any is swapped in, so a failure leaves the store as it was
+    columns = calloc(store->field_count, sizeof(uint8_t *));
+    check_mem(columns);
+
+    int f = 0;
+    for (f = 0; f < store->field_count; f++) {
+        columns[f] = aligned_alloc(COLUMN_STORE_ALIGN, column_bytes(store->fields[f].size, capacity));
+        check_mem(columns[f]);
+    }
+
+    for (f = 0; f < store->field_count; f++) {
+        if (store->columns[f]) {
+            memcpy(columns[f], store->columns[f], store->fields[f].size * (size_t) store->length);
+        }
+        free(store->columns[f]);
+    }
+
+    free(store->columns);
+    store->columns = columns;
+    store->capacity = capacity;
+
+    return CERB_OK;
+
+error:
+    if (columns) {
+        for (f = 0; f < store->field_count; f++) {
+            free(columns[f]);
+        }
+        free(columns);
+    }
+    return CERB_ERR;
+}
+
+int ColumnStore_push(ColumnStore *store, const void *row)
+{
+    check(store != NULL, "Somehow got store that is NULL.");
+    check(row != NULL, "Somehow got row that is NULL.");
+
+    if (store->length == store->capacity) {
+        check(store->capacity <= INT32_MAX / 2, "Store can't grow past INT32_MAX rows.");
+        int rc = ColumnStore_reserve(store, store->capacity * 2);
+        check(rc != CERB_ERR, "Couldn't grow store.");
+    }
+
+    int f = 0, i = store->length;
+    for (f = 0; f < store->field_count; f++) {
+        copy_field(ColumnStore_at(store, f, i), (const uint8_t *) row + store->fields[f].offset, store->fields[f].size);
+    }
+    store->length++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int ColumnStore_get(ColumnStore *store, int i, void *row)
+{
+    check(store != NULL, "Somehow got store that is NULL.");
+    check(row != NULL, "Somehow got row that is NULL.");
+    check(i >= 0 && i < store->length, "Index %d is out of bounds.", i);
+
+    int f = 0;
+    for (f = 0; f < store->field_count; f++) {
+        copy_field((uint8_t *) row + store->fields[f].offset, ColumnStore_at(store, f, i), store->fields[f].size);
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int ColumnStore_set(ColumnStore *store, int i, const void *row)
+{
+    check(store != NULL, "Somehow got store that is NULL.");
+    check(row != NULL, "Somehow got row that is NULL.");
+    check(i >= 0 && i < store->length, "Index %d is out of bounds.", i);
+
+    int f = 0;
+    for (f = 0; f < store->field_count; f++) {
+        copy_field(ColumnStore_at(store, f, i), (const uint8_t *) row + store->fields[f].offset, store->fields[f].size);
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int ColumnStore_pop(ColumnStore *store, void *row)
+{
+    check(store != NULL, "Somehow got store that is NULL.");
+    check(store->length > 0, "Can't pop from empty store.");
+
+    if (row) {
+        int rc = ColumnStore_get(store, store->length - 1, row);
+        check(rc != CERB_ERR, "Couldn't copy last row.");
+    }
+    store->length--;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *ColumnStore_column(ColumnStore *store, int field)
+{
+    check(store != NULL, "Somehow got store that is NULL.");
+    check(field >= 0 && field < store->field_count, "Field %d doesn't exist.", field);
+
+    return store->columns[field];
+
+error:
+    return NULL;
+}
+
+int ColumnStore_destroy(ColumnStore **store)
+{
+    check(store != NULL, "Somehow got reference to store that is NULL.");
+
+    if (*store) {
+        int f = 0;
+        if ((*store)->columns) {
+            for (f = 0; f < (*store)->field_count; f++) {
+                free((*store)->columns[f]);
+            }
+        }
+        free((*store)->columns);
+        free((*store)->fields);
+        free(*store);
+        *store = NULL;
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
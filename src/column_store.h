@@ -0,0 +1,58 @@
+#ifndef C4B54E3B_D9D4_4FA3_834A_8CDDDAD3E1AC
+#define C4B54E3B_D9D4_4FA3_834A_8CDDDAD3E1AC
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dbg.h"
+
+// one field of the row struct: where it is and how big it is
+typedef struct ColumnField {
+    size_t offset;
+    size_t size;
+} ColumnField;
+
+// schema entry for member of struct type, e.g. COLUMN_FIELD(Event, timestamp)
+#define COLUMN_FIELD(type, member) { offsetof(type, member), sizeof(((type *) 0)->member) }
+
+// every column starts at a cache line
+#define COLUMN_STORE_ALIGN 64
+
+// rows of a struct stored field by field, every field gets its own contiguous column
+// so scanning one field reads only that field and can go straight through a vectorised loop
+typedef struct ColumnStore {
+    int length;
+    int capacity;
+    int field_count;
+    size_t row_size; // size of the struct rows are copied from and into
+    ColumnField *fields;
+    uint8_t **columns;
+} ColumnStore;
+
+// create an empty store for rows of row_size bytes described by field_count fields ( the schema is copied )
+ColumnStore *ColumnStore_create(const ColumnField *fields, int field_count, size_t row_size, int initial_capacity);
+// make room for at least capacity rows
+int ColumnStore_reserve(ColumnStore *store, int capacity);
+
+// copy fields of row onto the end of every column
+int ColumnStore_push(ColumnStore *store, const void *row);
+// copy fields of row i into row ( bytes outside the schema are left alone )
+int ColumnStore_get(ColumnStore *store, int i, void *row);
+// overwrite row i with fields of row
+int ColumnStore_set(ColumnStore *store, int i, const void *row);
+// copy the last row into row ( if it isn't NULL ) and remove it
+int ColumnStore_pop(ColumnStore *store, void *row);
+
+// raw column of field, valid until the store grows, cast it to the field's type and scan length elements
+void *ColumnStore_column(ColumnStore *store, int field);
+
+// free the store and its columns, pass a reference to make it NULL after freeing
+int ColumnStore_destroy(ColumnStore **store);
+
+#define ColumnStore_length(S) ((S)->length)
+// pointer to field F of row I ( no bounds checks )
+#define ColumnStore_at(S, F, I) ((void *) ((S)->columns[(F)] + (size_t) (I) * (S)->fields[(F)].size))
+
+#endif /* C4B54E3B_D9D4_4FA3_834A_8CDDDAD3E1AC */
@@ -0,0 +1,336 @@
+#include "cow_darray.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* packing version pointer with its reference count */
+
+#define COW_COUNT_SHIFT 48
+#define COW_COUNT_ONE ((uint64_t) 1 << COW_COUNT_SHIFT)
+#define COW_POINTER_MASK (COW_COUNT_ONE - 1)
+#define COW_COUNT_MAX ((uint64_t) 0xFFFF)
+
+static inline CowDArraySnapshot *CowDArray_version(uint64_t packed)
+{
+    return (CowDArraySnapshot *) (uintptr_t) (packed & COW_POINTER_MASK);
+}
+
+static inline uint64_t CowDArray_count(uint64_t packed)
+{
+    return packed >> COW_COUNT_SHIFT;
+}
+
+/* versions and chunks */
+
+static CowDArraySnapshot *CowDArray_version_create(int chunk_capacity)
+{
+    CowDArraySnapshot *version = calloc(1, sizeof(CowDArraySnapshot));
+    check_mem(version);
+
+    atomic_init(&version->refs, 0);
+    version->chunk_capacity = chunk_capacity;
+
+    if (chunk_capacity) {
+        version->chunks = malloc(sizeof(CowDArrayChunk *) * chunk_capacity);
+        check_mem(version->chunks);
+    }
+
+    return version;
+
+error:
+    free(version);
+    return NULL;
+}
+
+static inline void CowDArray_chunk_release(CowDArrayChunk *chunk)
+{
+    if (atomic_fetch_sub_explicit(&chunk->refs, 1, memory_order_acq_rel) == 1) {
+        free(chunk);
+    }
+}
+
+static void CowDArray_version_free(CowDArraySnapshot *version)
+{
+    int i = 0;
+    for (i = 0; i < version->chunk_count; i++) {
+        CowDArray_chunk_release(version->chunks[i]);
+    }
+    free(version->chunks);
+    free(version);
+}
+
+// writer's draft starts as a copy of the current chunk table sharing every chunk
+static CowDArraySnapshot *CowDArray_draft(CowDArray *array)
+{
+    if (array->draft) return array->draft;
+
+    // only the writer replaces current, so it can't change or go away under us
+    CowDArraySnapshot *current = CowDArray_version(atomic_load_explicit(&array->current, memory_order_acquire));
+
+    CowDArraySnapshot *draft = CowDArray_version_create(current->chunk_capacity);
+    check(draft != NULL, "Couldn't create draft.");
+
+    int i = 0;
+    for (i = 0; i < current->chunk_count; i++) {
+        draft->chunks[i] = current->chunks[i];
+        atomic_fetch_add_explicit(&draft->chunks[i]->refs, 1, memory_order_relaxed);
+    }
+    draft->chunk_count = current->chunk_count;
+    draft->length = current->length;
+
+    array->draft = draft;
+
+    return draft;
+
+error:
+    return NULL;
+}
+
+// chunk shared with a published version is copied before the first write to it
+static CowDArrayChunk *CowDArray_writable_chunk(CowDArraySnapshot *draft, int c)
+{
+    CowDArrayChunk *chunk = draft->chunks[c];
+
+    if (atomic_load_explicit(&chunk->refs, memory_order_acquire) == 1) return chunk;
+
+    CowDArrayChunk *copy = malloc(sizeof(CowDArrayChunk));
+    check_mem(copy);
+
+    atomic_init(&copy->refs, 1);
+    memcpy(copy->contents, chunk->contents, sizeof(copy->contents));
+
+    CowDArray_chunk_release(chunk);
+    draft->chunks[c] = copy;
+
+    return copy;
+
+error:
+    return NULL;
+}
+
+/* create and destroy */
+
+CowDArray *CowDArray_create(void)
+{
+    CowDArray *array = calloc(1, sizeof(CowDArray));
+    check_mem(array);
+
+    CowDArraySnapshot *empty = CowDArray_version_create(0);
+    check_mem(empty);
+    check(((uintptr_t) empty & ~COW_POINTER_MASK) == 0, "Pointer doesn't fit in 48 bits.");
+
+    atomic_init(&array->current, (uint64_t) (uintptr_t) empty | COW_COUNT_ONE);
+
+    return array;
+
+error:
+    free(array);
+    return NULL;
+}
+
+// stop publishing version and hand references taken from current over to version->refs
+static void CowDArray_retire(uint64_t packed)
+{
+    CowDArraySnapshot *version = CowDArray_version(packed);
+    // array's own reference isn't handed over, it goes away right here
+    long handed_over = (long) CowDArray_count(packed) - 1;
+
+    if (atomic_fetch_add_explicit(&version->refs, handed_over, memory_order_acq_rel) == -handed_over) {
+        CowDArray_version_free(version);
+    }
+}
+
+int CowDArray_destroy(CowDArray **array)
+{
+    check(array != NULL, "Somehow got address of array that is NULL.");
+    check(*array != NULL, "Somehow got array that is NULL.");
+
+    if ((*array)->draft) {
+        CowDArray_version_free((*array)->draft);
+    }
+    CowDArray_retire(atomic_load_explicit(&(*array)->current, memory_order_acquire));
+
+    free(*array);
+    *array = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* writer operations */
+
+int CowDArray_push(CowDArray *array, void *data)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    CowDArraySnapshot *draft = CowDArray_draft(array);
+    check(draft != NULL, "Couldn't push in array.");
+
+    int c = draft->length / COW_DARRAY_CHUNK;
+    CowDArrayChunk *chunk = NULL;
+
+    if (c == draft->chunk_count) {
+        if (draft->chunk_count == draft->chunk_capacity) {
+            int capacity = draft->chunk_capacity ? draft->chunk_capacity * 2 : 4;
+            CowDArrayChunk **chunks = realloc(draft->chunks, sizeof(CowDArrayChunk *) * capacity);
+            check_mem(chunks);
+            draft->chunks = chunks;
+            draft->chunk_capacity = capacity;
+        }
+
+        chunk = malloc(sizeof(CowDArrayChunk));
+        check_mem(chunk);
+        atomic_init(&chunk->refs, 1);
+        draft->chunks[draft->chunk_count++] = chunk;
+    } else {
+        chunk = CowDArray_writable_chunk(draft, c);
+        check(chunk != NULL, "Couldn't copy chunk.");
+    }
+
+    chunk->contents[draft->length % COW_DARRAY_CHUNK] = data;
+    draft->length++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *CowDArray_pop(CowDArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    CowDArraySnapshot *draft = CowDArray_draft(array);
+    check(draft != NULL, "Couldn't pop from array.");
+    check(draft->length > 0, "Couldn't pop from empty array.");
+
+    draft->length--;
+    void *data = draft->chunks[draft->length / COW_DARRAY_CHUNK]->contents[draft->length % COW_DARRAY_CHUNK];
+
+    // popping leaves chunks untouched, we only let go of the ones which got empty
+    if (draft->length % COW_DARRAY_CHUNK == 0) {
+        CowDArray_chunk_release(draft->chunks[--draft->chunk_count]);
+    }
+
+    return data;
+
+error:
+    return NULL;
+}
+
+int CowDArray_set(CowDArray *array, int i, void *data)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    CowDArraySnapshot *draft = CowDArray_draft(array);
+    check(draft != NULL, "Couldn't set in array.");
+    check(i < draft->length, "Couldn't set element number that hasn't been added to list previously.");
+    check(i >= 0, "Enter valid element position.");
+
+    CowDArrayChunk *chunk = CowDArray_writable_chunk(draft, i / COW_DARRAY_CHUNK);
+    check(chunk != NULL, "Couldn't copy chunk.");
+
+    chunk->contents[i % COW_DARRAY_CHUNK] = data;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *CowDArray_get(CowDArray *array, int i)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    CowDArraySnapshot *view = array->draft ? array->draft
+        : CowDArray_version(atomic_load_explicit(&array->current, memory_order_acquire));
+
+    return CowDArraySnapshot_get(view, i);
+
+error:
+    return NULL;
+}
+
+int CowDArray_length(CowDArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    CowDArraySnapshot *view = array->draft ? array->draft
+        : CowDArray_version(atomic_load_explicit(&array->current, memory_order_acquire));
+
+    return view->length;
+
+error:
+    return CERB_ERR;
+}
+
+int CowDArray_publish(CowDArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    if (!array->draft) return CERB_OK;
+
+    check(((uintptr_t) array->draft & ~COW_POINTER_MASK) == 0, "Pointer doesn't fit in 48 bits.");
+
+    uint64_t published = (uint64_t) (uintptr_t) array->draft | COW_COUNT_ONE;
+    uint64_t old = atomic_exchange_explicit(&array->current, published, memory_order_acq_rel);
+    array->draft = NULL;
+
+    CowDArray_retire(old);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* reader operations */
+
+CowDArraySnapshot *CowDArray_snapshot(CowDArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    // one CAS both reads current and takes a reference on it, so it can't be freed in between
+    // a full count would wrap to 0 and let the version be freed under its readers, so we refuse instead
+    uint64_t packed = atomic_load_explicit(&array->current, memory_order_relaxed);
+    do {
+        check(CowDArray_count(packed) < COW_COUNT_MAX, "Version already has %d snapshots.", COW_DARRAY_MAX_SNAPSHOTS);
+    } while (!atomic_compare_exchange_weak_explicit(&array->current, &packed, packed + COW_COUNT_ONE,
+                memory_order_acquire, memory_order_relaxed));
+
+    return CowDArray_version(packed);
+
+error:
+    return NULL;
+}
+
+int CowDArray_release(CowDArray *array, CowDArraySnapshot **snapshot)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(snapshot != NULL, "Somehow got address of snapshot that is NULL.");
+    check(*snapshot != NULL, "Somehow got snapshot that is NULL.");
+
+    // while our version is still current we give our reference back where we took it from
+    uint64_t packed = atomic_load_explicit(&array->current, memory_order_relaxed);
+    while (CowDArray_version(packed) == *snapshot && CowDArray_count(packed) > 1) {
+        if (atomic_compare_exchange_weak_explicit(&array->current, &packed, packed - COW_COUNT_ONE,
+                    memory_order_release, memory_order_relaxed)) {
+            *snapshot = NULL;
+            return CERB_OK;
+        }
+    }
+
+    // otherwise it has been retired and our reference got handed over to refs
+    if (atomic_fetch_sub_explicit(&(*snapshot)->refs, 1, memory_order_acq_rel) == 1) {
+        CowDArray_version_free(*snapshot);
+    }
+    *snapshot = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
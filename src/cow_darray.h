@@ -0,0 +1,85 @@
+#ifndef CC21C52A_9C48_41E7_BA12_1D9B847589B0
+#define CC21C52A_9C48_41E7_BA12_1D9B847589B0
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dbg.h"
+
+// elements per chunk, a write copies at most one chunk
+#define COW_DARRAY_CHUNK 64
+
+typedef struct CowDArrayChunk {
+    atomic_int refs; // how many versions share this chunk
+    void *contents[COW_DARRAY_CHUNK];
+} CowDArrayChunk;
+
+// one immutable version of an array, readers get these from CowDArray_snapshot
+typedef struct CowDArraySnapshot {
+    atomic_long refs; // references handed over from CowDArray->current when it stopped being current
+    int length;
+    int chunk_count;
+    int chunk_capacity;
+    CowDArrayChunk **chunks;
+} CowDArraySnapshot;
+
+// array with one writer and any number of lock-free readers
+// writer changes a private draft ( copying only chunks it touches ) and makes it visible with CowDArray_publish
+// readers take O(1) snapshots which never change, and neither side ever waits for the other
+typedef struct CowDArray {
+    // published version, its pointer lives in the low 48 bits and the top 16 bits count
+    // references taken from it ( one of them is the array's own )
+    _Atomic uint64_t current;
+    CowDArraySnapshot *draft; // writer's unpublished version, NULL if nothing changed since last publish
+} CowDArray;
+
+// create an empty array
+CowDArray *CowDArray_create(void);
+
+/* writer side ( only one thread at a time ) */
+
+// push data at the end of draft
+int CowDArray_push(CowDArray *array, void *data);
+// pop data from the end of draft and return
+void *CowDArray_pop(CowDArray *array);
+// set element i of draft to data
+int CowDArray_set(CowDArray *array, int i, void *data);
+// get element i as writer sees it ( draft if there is one )
+void *CowDArray_get(CowDArray *array, int i);
+// length as writer sees it ( draft if there is one )
+int CowDArray_length(CowDArray *array);
+// make draft the version new snapshots see, snapshots taken before keep seeing old one
+int CowDArray_publish(CowDArray *array);
+// free the array ( THIS DOES NOT FREE THE DATA IN IT ), every snapshot has to be released before this
+int CowDArray_destroy(CowDArray **array);
+
+/* reader side ( any thread, any time ) */
+
+// 16 bit reader count minus the reference publish holds
+#define COW_DARRAY_MAX_SNAPSHOTS 65534
+
+// take current published version in O(1), it stays the same until released
+// readers are counted in 16 bits next to the version pointer, so at most COW_DARRAY_MAX_SNAPSHOTS snapshots
+// of one version can be held at once, past that this returns NULL until some are released
+CowDArraySnapshot *CowDArray_snapshot(CowDArray *array);
+// give snapshot back ( pass a reference to make it NULL )
+int CowDArray_release(CowDArray *array, CowDArraySnapshot **snapshot);
+
+#define CowDArraySnapshot_length(S) ((S)->length)
+
+// get element i of a snapshot
+static inline void *CowDArraySnapshot_get(CowDArraySnapshot *snapshot, int i)
+{
+    check(snapshot != NULL, "Somehow got snapshot that is NULL.");
+    check(i < snapshot->length, "Couldn't get element number that hasn't been added to list previously.");
+    check(i >= 0, "Enter valid element position.");
+
+    return snapshot->chunks[i / COW_DARRAY_CHUNK]->contents[i % COW_DARRAY_CHUNK];
+
+error:
+    return NULL;
+}
+
+#endif /* CC21C52A_9C48_41E7_BA12_1D9B847589B0 */
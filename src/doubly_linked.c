@@ -28,9 +28,35 @@ error:
     return NULL;
 }
 
-static inline DLinkedNode *DLinkedNode_create()
+DLinked *DLinked_create_pooled(DLinked_cmp cmp, NodePool *pool)
 {
-    DLinkedNode *node = calloc(1, sizeof(DLinkedNode));
+    DLinked *list = DLinked_create(cmp);
+    check(list != NULL, "Failed to create list.");
+
+    if (pool) {
+        check(pool->node_size >= sizeof(DLinkedNode), "Pool's nodes are too small for DLinkedNode.");
+        list->pool = NodePool_retain(pool);
+    } else {
+        list->pool = NodePool_create(sizeof(DLinkedNode), 0);
+    }
+    check(list->pool != NULL, "Failed to get a pool for list.");
+
+    return list;
+
+error:
+    free(list);
+    return NULL;
+}
+
+// new empty list which takes nodes from the same place as list does
+static inline DLinked *DLinked_create_like(DLinked *list)
+{
+    return list->pool ? DLinked_create_pooled(list->cmp_template, list->pool) : DLinked_create(list->cmp_template);
+}
+
+static inline DLinkedNode *DLinkedNode_create(DLinked *list)
+{
+    DLinkedNode *node = list->pool ? NodePool_alloc(list->pool) : calloc(1, sizeof(DLinkedNode));
     check_mem(node);
 
     return node;
@@ -39,6 +65,35 @@ error:
     return NULL;
 }
 
+static inline void DLinkedNode_destroy(DLinked *list, DLinkedNode *node)
+{
+    if (list->pool) {
+        NodePool_free(list->pool, node);
+    } else {
+        free(node);
+    }
+}
+
+// free every node and list itself, handler_func ( if there's one ) gets each node's data first
+static void DLinked_free_all(DLinked *list, free_func handler_func)
+{
+    // if nobody else uses the pool its slabs go all at once, nodes don't have to be given back one by one
+    int drop_nodes = list->pool && NodePool_sole_user(list->pool);
+
+    if (handler_func || !drop_nodes) {
+        DLinkedNode *cur_node = list->first;
+        while (cur_node) {
+            DLinkedNode *next_node = cur_node->next;
+            if (handler_func) handler_func(cur_node->data);
+            if (!drop_nodes) DLinkedNode_destroy(list, cur_node);
+            cur_node = next_node;
+        }
+    }
+
+    if (list->pool) NodePool_release(&list->pool);
+    free(list);
+}
+
 /* insert operations */
 
 int DLinked_push(DLinked *list, void *data)
@@ -47,7 +102,7 @@ int DLinked_push(DLinked *list, void *data)
     check(data != NULL, "Somehow got data that is NULL.");
     check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
 
-    DLinkedNode *new_node = DLinkedNode_create();
+    DLinkedNode *new_node = DLinkedNode_create(list);
     check(new_node != NULL, "Failed to push in list.");
     new_node->data = data;
 
@@ -74,7 +129,7 @@ int DLinked_unshift(DLinked *list, void *data)
     check(data != NULL, "Somehow got data that is NULL.");
     check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
 
-    DLinkedNode *new_node = DLinkedNode_create();
+    DLinkedNode *new_node = DLinkedNode_create(list);
     check(new_node != NULL, "Failed to push in list.");
     new_node->data = data;
 
@@ -95,6 +150,9 @@ error:
     return CERB_ERR;
 }
 
+#ifdef CERB_DEBUG_LISTS
+
+// full scan, also catches nodes which belong to some other list
 static inline int in_list(DLinked *list, DLinkedNode *node) // add start_node too
 {
     DLinked_iter (list, first, next, cur) { // change first with start_node
@@ -106,6 +164,21 @@ static inline int in_list(DLinked *list, DLinkedNode *node) // add start_node to
     return 0;
 }
 
+#else
+
+// O(1), node's neighbours ( or list's ends ) have to point back at it
+// that's all it checks, a node of another list passes and passing a freed node is undefined behaviour
+// ( it's read before anything can tell ), both are on the caller unless built with CERB_DEBUG_LISTS
+static inline int in_list(DLinked *list, DLinkedNode *node)
+{
+    if (node == NULL) return 0;
+
+    return (node->prev ? node->prev->next == node : list->first == node)
+        && (node->next ? node->next->prev == node : list->last == node);
+}
+
+#endif
+
 int DLinked_insert_after(DLinked *list, DLinkedNode *after, void *data)
 {
     check(list != NULL, "Somehow got list that is NULL.");
@@ -118,7 +191,7 @@ int DLinked_insert_after(DLinked *list, DLinkedNode *after, void *data)
         check(rc != CERB_ERR, "Failed insert after %p", after);
         return rc;
     } else if (in_list(list, after)) {
-        DLinkedNode *new_node = DLinkedNode_create();
+        DLinkedNode *new_node = DLinkedNode_create(list);
         check(new_node != NULL, "Failed to insert after %p.", after);
         new_node->data = data;
 
@@ -149,7 +222,7 @@ int DLinked_insert_before(DLinked *list, DLinkedNode *before, void *data)
         check(rc != CERB_ERR, "Failed to insert before %p", before);
         return rc;
     } else if (in_list(list, before)) {
-        DLinkedNode *new_node = DLinkedNode_create();
+        DLinkedNode *new_node = DLinkedNode_create(list);
         check(new_node != NULL, "Failed to insert before %p", before);
         new_node->data = data;
 
@@ -180,13 +253,13 @@ void *DLinked_pop(DLinked *list)
     data = list->last->data;
 
     if (list->count == 1) {
-        free(list->last);
+        DLinkedNode_destroy(list, list->last);
         list->first = NULL;
         list->last = NULL;
         list->count = 0; // or --; as count gets 0
     } else {
         DLinkedNode *new_last = list->last->prev;
-        free(list->last);
+        DLinkedNode_destroy(list, list->last);
         list->last = new_last;
         new_last->next = NULL;
         list->count--;
@@ -206,13 +279,13 @@ void *DLinked_shift(DLinked *list)
     data = list->first->data;
 
     if (list->count == 1) {
-        free(list->first);
+        DLinkedNode_destroy(list, list->first);
         list->first = NULL;
         list->last = NULL;
         list->count = 0;
     } else {
         DLinkedNode *new_first = list->first->next;
-        free(list->first);
+        DLinkedNode_destroy(list, list->first);
         list->first = new_first;
         new_first->prev = NULL;
         list->count--;
@@ -237,7 +310,7 @@ void *DLinked_remove(DLinked *list, DLinkedNode *node)
         data = node->data;
         node->prev->next = node->next;
         node->next->prev = node->prev;
-        free(node);
+        DLinkedNode_destroy(list, node);
         list->count--;
     } else {
         log_err("Couldn't find node %p.", node);
@@ -263,7 +336,7 @@ void *DLinked_remove_after(DLinked *list, DLinkedNode *after)
         after->next->prev = after;
 
         data = delete_node->data;
-        free(delete_node);
+        DLinkedNode_destroy(list, delete_node);
         list->count--;
     } else {
         log_err("Couldn't find node %p.", after);
@@ -289,7 +362,7 @@ void *DLinked_remove_before(DLinked *list, DLinkedNode *before)
         before->prev->next = before;
 
         data = delete_node->data;
-        free(delete_node);
+        DLinkedNode_destroy(list, delete_node);
         list->count--;
     } else {
         log_err("Couldn't find node %p.", before);
@@ -330,12 +403,14 @@ int DLinked_join(DLinked **list1, DLinked **list2)
     check((*list1)->count + (*list2)->count <= UINT32_MAX,
     "Couldn't join lists as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
     check((*list1)->cmp_template == (*list2)->cmp_template, "Couldn't join lists of different cmp_templates");
+    check((*list1)->pool == (*list2)->pool, "Couldn't join lists which take nodes from different pools.");
 
     (*list1)->last->next = (*list2)->first;
     (*list2)->first->prev = (*list1)->last;
     (*list1)->last = (*list2)->last;
     (*list1)->count += (*list2)->count;
 
+    if ((*list2)->pool) NodePool_release(&(*list2)->pool);
     free(*list2);
     *list2 = NULL;
 
@@ -365,7 +440,7 @@ DLinked *DLinked_split(DLinked **list, DLinkedNode *from_node, DLinkedNode *to_n
     if (from_node == NULL) {
         check(to_node->next, "Doesn't make sense to split from first including last.");
 
-        new_list = DLinked_create((*list)->cmp_template);
+        new_list = DLinked_create_like(*list);
         check(new_list != NULL, "Couldn't create new list.");
 
         new_list->first = (*list)->first;
@@ -378,7 +453,7 @@ DLinked *DLinked_split(DLinked **list, DLinkedNode *from_node, DLinkedNode *to_n
     } else if (to_node == NULL) {
         check(from_node != (*list)->first, "Doesn't make sense to split from first including last.");
 
-        new_list = DLinked_create((*list)->cmp_template);
+        new_list = DLinked_create_like(*list);
         check(new_list != NULL, "Couldn't create new list.");
 
         new_list->first = from_node;
@@ -396,7 +471,7 @@ DLinked *DLinked_split(DLinked **list, DLinkedNode *from_node, DLinkedNode *to_n
             return new_list;
         }
 
-        new_list = DLinked_create((*list)->cmp_template);
+        new_list = DLinked_create_like(*list);
         check(new_list != NULL, "Couldn't create new list.");
 
         from_node->prev->next = to_node->next;
@@ -444,25 +519,12 @@ int DLinked_destroy(DLinked **list)
 {
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
-    
-    if (!(*list)->count) goto empty_list; // if list is empty skip the loop
-
-    DLinkedNode *cur_node = (*list)->first;
-    DLinkedNode *next_node = NULL;
-    
-    for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
-        free(cur_node);
-        cur_node = next_node;
-    }
-    free(cur_node); // free the last one and we are done
 
-empty_list: // fall through
-    free(*list);
+    DLinked_free_all(*list, NULL);
     *list = NULL;
 
     return CERB_OK;
 
-
 error:
     return CERB_ERR;
 }
@@ -471,21 +533,7 @@ int DLinked_clear_destroy(DLinked **list)
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
 
-    if (!(*list)->count) goto empty_list; // if list is empty skip the loop
-
-    DLinkedNode *cur_node = (*list)->first;
-    DLinkedNode *next_node = NULL;
-    
-    for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
-        free(cur_node->data);
-        free(cur_node);
-        cur_node = next_node;
-    }
-    free(cur_node->data);
-    free(cur_node); // free the last one and we are done
-
-empty_list: // fall through
-    free(*list);
+    DLinked_free_all(*list, free);
     *list = NULL;
 
     return CERB_OK;
@@ -500,16 +548,10 @@ int DLinked_free_complex_data(DLinked **list, free_func handler_func)
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
 
-    DLinkedNode *first = (*list)->first;
-    DLinkedNode *freeable = NULL;
-    for (; first != NULL;) {
-        freeable = first;
-        first = first->next; 
-        handler_func(freeable->data);
-        free(freeable);
-    }
-    free(*(list));
-    *(list) = NULL;
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    DLinked_free_all(*list, handler_func);
+    *list = NULL;
 
     return CERB_OK;
 
@@ -522,12 +564,7 @@ int DLinked_free_list(DLinked **list)
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
 
-    DLinked_iter (*list, first, next, cur) {
-        free(cur);
-    }
-
-    free(*list);
-
+    DLinked_free_all(*list, NULL);
     *list = NULL;
 
     return CERB_OK;
@@ -558,4 +595,119 @@ int DLinked_sorted_insert(DLinked *list, void *data)
 
 error:
     return rc;
-}
\ No newline at end of file
+}
+/* sorting */
+
+// sorting only follows next, prev is put back in one pass once the order is final
+
+// cut the non-decreasing run starting at start off the rest of the chain and return the rest
+static inline DLinkedNode *cut_run(DLinked_cmp cmp, DLinkedNode *start)
+{
+    DLinkedNode *cur = start;
+    while (cur->next && cmp(cur->data, cur->next->data) <= 0) cur = cur->next;
+
+    DLinkedNode *rest = cur->next;
+    cur->next = NULL;
+    return rest;
+}
+
+// merge sorted chains a and b, on ties a goes first so equal elements keep their order
+// *tail gets the last node of the merged chain
+static DLinkedNode *merge_chains(DLinked_cmp cmp, DLinkedNode *a, DLinkedNode *b, DLinkedNode **tail)
+{
+    DLinkedNode head = { NULL, NULL, NULL };
+    DLinkedNode *cur = &head;
+
+    while (a && b) {
+        if (cmp(b->data, a->data) < 0) {
+            cur->next = b;
+            b = b->next;
+        } else {
+            cur->next = a;
+            a = a->next;
+        }
+        cur = cur->next;
+    }
+
+    cur->next = a ? a : b;
+    while (cur->next) cur = cur->next;
+
+    *tail = cur;
+    return head.next;
+}
+
+static void relink_prev(DLinked *list)
+{
+    DLinkedNode *prev = NULL;
+    DLinked_iter (list, first, next, cur) {
+        cur->prev = prev;
+        prev = cur;
+    }
+    list->last = prev;
+}
+
+int DLinked_sort(DLinked *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    if (list->count < 2) return CERB_OK;
+
+    // every pass merges neighbouring runs pairwise, so already sorted stretches cost nothing extra
+    uint32_t runs = 0;
+    do {
+        DLinkedNode head = { NULL, NULL, NULL };
+        DLinkedNode *tail = &head;
+        DLinkedNode *rest = list->first;
+        runs = 0;
+
+        while (rest) {
+            DLinkedNode *a = rest;
+            rest = cut_run(list->cmp_template, a);
+            DLinkedNode *b = rest;
+            if (b) rest = cut_run(list->cmp_template, b);
+
+            DLinkedNode *merged_tail = NULL;
+            tail->next = merge_chains(list->cmp_template, a, b, &merged_tail);
+            tail = merged_tail;
+            runs++;
+        }
+
+        list->first = head.next;
+    } while (runs > 1);
+
+    relink_prev(list);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int DLinked_merge_sorted(DLinked **list1, DLinked **list2)
+{
+    check(list1 != NULL, "Somehow got an address of the list1 that is NULL.");
+    check(*list1 != NULL, "Somehow got list1 that is NULL.");
+    check(list2 != NULL, "Somehow got an address of the list2 that is NULL.");
+    check(*list2 != NULL, "Somehow got list2 that is NULL.");
+    check(*list1 != *list2, "Couldn't merge list with itself.");
+    check((uint64_t) (*list1)->count + (*list2)->count <= UINT32_MAX,
+    "Couldn't merge lists as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
+    check((*list1)->cmp_template == (*list2)->cmp_template, "Couldn't merge lists of different cmp_templates");
+    check((*list1)->pool == (*list2)->pool, "Couldn't merge lists which take nodes from different pools.");
+
+    if ((*list2)->count) {
+        DLinkedNode *tail = NULL;
+        (*list1)->first = merge_chains((*list1)->cmp_template, (*list1)->first, (*list2)->first, &tail);
+        (*list1)->count += (*list2)->count;
+        relink_prev(*list1);
+    }
+
+    if ((*list2)->pool) NodePool_release(&(*list2)->pool);
+    free(*list2);
+    *list2 = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 #include "dbg.h"
+#include "node_pool.h"
 
 typedef int (*DLinked_cmp) (const void *data1, const void *data2);
 typedef void (*free_func) (void *data);
@@ -29,10 +30,15 @@ typedef struct DLinked {
     // this is for sorting (if you'll need) when creating list you can pass NULL and default cmp will be set
     DLinked_cmp cmp_template;
     uint32_t count;
+    NodePool *pool; // where nodes come from, NULL if every node is malloc'd on its own
 } DLinked;
 
 // create DLinked *list ( specify cmp if you need to sorted insert )
 DLinked *DLinked_create(DLinked_cmp cmp); //
+// create DLinked *list which takes its nodes from pool ( sizeof(DLinkedNode) byte nodes ), pass NULL to give it its own pool
+// lists can share a pool, destroying the last one using it frees whole slabs instead of single nodes
+// only lists with the same pool can be joined, split gives back a list with the same pool
+DLinked *DLinked_create_pooled(DLinked_cmp cmp, NodePool *pool);
 // push data in list
 int DLinked_push(DLinked *list, void *data); //
 // pop data and return
@@ -41,6 +47,9 @@ void *DLinked_pop(DLinked *list); //
 int DLinked_unshift(DLinked *list, void *data); //
 // remove first element from list and return
 void *DLinked_shift(DLinked *list); //
+// calls taking a node don't scan the list to find it, they only check in O(1) that its neighbours point back at it
+// a node of another list isn't caught and passing a freed node is undefined behaviour
+// build with CERB_DEBUG_LISTS ( make dev does ) to have every node looked up in the list
 // remove DLinkedNode *node from list
 void *DLinked_remove(DLinked *list, DLinkedNode *node); //
 // insert node after DLinkedNode *node
@@ -77,6 +86,11 @@ int DLinked_free_list(DLinked **list); // to free just list and its nodes, but n
 
 // sorted insert in list ( SHOULD BE INSERTED WITH THIS FUNCTION ONLY, IF YOU WANT TO HAVE SORTED ARRAY )
 int DLinked_sorted_insert(DLinked *list, void *data);
+// sort list in place with cmp_template ( stable, O(n log n), allocates nothing )
+// natural merge sort, so lists which are already mostly in order sort in close to one pass
+int DLinked_sort(DLinked *list);
+// merge sorted list2 into sorted list1 in one pass and free list2 ( same rules as join ), provide references to them
+int DLinked_merge_sorted(DLinked **list1, DLinked **list2);
 
 #define DLinked_get_count(list) list->count
 
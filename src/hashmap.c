@@ -59,6 +59,16 @@ error:
     return NULL;
 }
 
+int Hashmap_set_huge_threshold(Hashmap *map, size_t threshold)
+{
+    check(map != NULL, "Somehow got map that is NULL.");
+
+    return DArray_set_huge_threshold(map->buckets, threshold);
+
+error:
+    return CERB_ERR;
+}
+
 void Hashmap_destroy(Hashmap *map)
 {
     check(map != NULL, "Somehow got map that is NULL.");
@@ -213,12 +223,10 @@ int Hashmap_join(Hashmap **map1, Hashmap **map2, free_func handler_func, int fla
                 }
                 free(node);
             }
-            free(array->contents);
-            free(array);
+            DArray_destroy(&array);
         }
     }
-    free((*map2)->buckets->contents);
-    free((*map2)->buckets);
+    DArray_destroy(&(*map2)->buckets);
     free(*map2);
     
     map2 = NULL;
@@ -297,12 +305,13 @@ void *Hashmap_binary_search(Hashmap *map, void *key)
     DArray *bucket = Hashmap_find_bucket(map, key, 0, &hash);
     if (!bucket) return NULL;
 
-    int high = bucket->length - 1, low = 0, middle;
+    int high = bucket->length - 1, low = 0, middle, cmp;
     while (low <= high) {
         middle = (high + low) / 2;
-        if (map->cmp(((HashmapNode *) bucket->contents[middle])->data, key) < 0) {
+        cmp = map->cmp(((HashmapNode *) bucket->contents[middle])->data, key);
+        if (cmp < 0) {
             low = middle + 1;
-        } else if (map->cmp(((HashmapNode *) bucket->contents[middle])->data, key) > 0) {
+        } else if (cmp > 0) {
             high = middle - 1;
         } else {
             return ((HashmapNode *) bucket->contents[middle])->data;
@@ -334,12 +343,10 @@ int Hashmap_free_complex_data(Hashmap **map, free_func handler_func)
                 free(node);
                 // debug("bucket->length = %d", array->length);
             }
-            free(array->contents);
-            free(array);
+            DArray_destroy(&array);
         }
     }
-    free((*map)->buckets->contents);
-    free((*map)->buckets);
+    DArray_destroy(&(*map)->buckets);
     free(*map);
 
     *map = NULL;
@@ -38,6 +38,8 @@ typedef int (*Hashmap_traverse_cb) (HashmapNode *node);
 // specify hash_func ( default is fnv1 which hashes C strings )
 // number of hashmap buckets as the last argument
 Hashmap *Hashmap_create(Hashmap_compare cmp, Hashmap_hash hash_func, int number_of_buckets);
+// bucket arrays of threshold bytes or more go to transparent huge pages ( 0 turns it off, see DArray_set_huge_threshold )
+int Hashmap_set_huge_threshold(Hashmap *map, size_t threshold);
 // free HashmapNodes buckets and map ( DOES NOT FREE DATA WHICH YOU INSERTED )
 void Hashmap_destroy(Hashmap *map);
 // set ( insert ) data in a specific bucket
@@ -0,0 +1,120 @@
+#define _GNU_SOURCE // mremap
+#include "huge_alloc.h"
+#include "dbg.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+
+// map size bytes at a HUGE_PAGE_SIZE aligned address, by over-mapping and cutting off the misaligned ends
+static void *HugeAlloc_map_aligned(size_t size)
+{
+    size_t padded = size + HUGE_PAGE_SIZE;
+    uint8_t *mapping = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    check(mapping != MAP_FAILED, "Couldn't map %zu bytes.", padded);
+
+    uint8_t *aligned = (uint8_t *) (((uintptr_t) mapping + HUGE_PAGE_SIZE - 1) & ~(uintptr_t) (HUGE_PAGE_SIZE - 1));
+    if (aligned != mapping) {
+        munmap(mapping, (size_t) (aligned - mapping));
+    }
+    munmap(aligned + size, (size_t) (mapping + padded - (aligned + size)));
+
+    return aligned;
+
+error:
+    return NULL;
+}
+
+void *HugeAlloc_alloc(size_t size)
+{
+    size = HugeAlloc_round(size);
+
+    void *region = HugeAlloc_map_aligned(size);
+    if (!region) return NULL;
+
+    // only a hint, kernels without THP ( or with it disabled ) still give us a working mapping
+    madvise(region, size, MADV_HUGEPAGE);
+
+    return region;
+}
+
+void *HugeAlloc_realloc(void *ptr, size_t old_size, size_t new_size)
+{
+    if (!ptr) return HugeAlloc_alloc(new_size);
+
+    old_size = HugeAlloc_round(old_size);
+    new_size = HugeAlloc_round(new_size);
+
+    if (new_size == old_size) return ptr;
+
+    // shrinking and growing in place keep the alignment
+    void *region = mremap(ptr, old_size, new_size, 0);
+    if (region != MAP_FAILED) {
+        if (new_size > old_size) madvise((uint8_t *) region + old_size, new_size - old_size, MADV_HUGEPAGE);
+        return region;
+    }
+
+    // no room to grow in place, so reserve an aligned region and move the old pages over its start
+    region = HugeAlloc_map_aligned(new_size);
+    check(region != NULL, "Couldn't reserve region to grow into.");
+
+    void *moved = mremap(ptr, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, region);
+    if (moved == MAP_FAILED) {
+        munmap(region, new_size);
+        sentinel("Couldn't move region to its new place.");
+    }
+    madvise(moved, new_size, MADV_HUGEPAGE);
+
+    return moved;
+
+error:
+    return NULL;
+}
+
+void HugeAlloc_free(void *ptr, size_t size)
+{
+    if (ptr) munmap(ptr, HugeAlloc_round(size));
+}
+
+#else
+
+// no transparent huge pages here, aligned heap memory is the best we can do
+
+#include <string.h>
+
+void *HugeAlloc_alloc(size_t size)
+{
+    size = HugeAlloc_round(size);
+
+    void *region = aligned_alloc(HUGE_PAGE_SIZE, size);
+    if (region) memset(region, 0, size);
+
+    return region;
+}
+
+void *HugeAlloc_realloc(void *ptr, size_t old_size, size_t new_size)
+{
+    if (HugeAlloc_round(old_size) == HugeAlloc_round(new_size) && ptr) return ptr;
+
+    void *region = HugeAlloc_alloc(new_size);
+    check_mem(region);
+
+    if (ptr) {
+        memcpy(region, ptr, old_size < new_size ? old_size : new_size);
+        free(ptr);
+    }
+
+    return region;
+
+error:
+    return NULL;
+}
+
+void HugeAlloc_free(void *ptr, size_t size)
+{
+    (void) size;
+    free(ptr);
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef A37D1CBB_AF30_4379_96F7_BBE9B965BD90
+#define A37D1CBB_AF30_4379_96F7_BBE9B965BD90
+
+#include <stddef.h>
+
+#define HUGE_PAGE_SIZE ((size_t) 2 * 1024 * 1024)
+
+// allocations for big tables: regions are HUGE_PAGE_SIZE aligned and marked for transparent huge pages,
+// so random access over them needs one TLB entry per 2 MB instead of per 4 KB
+// memory from here is zeroed and must only be resized and freed with HugeAlloc functions ( size is needed )
+
+// allocate at least size bytes
+void *HugeAlloc_alloc(size_t size);
+// grow or shrink region of old_size bytes to new_size bytes, growing moves page tables, not the data
+void *HugeAlloc_realloc(void *ptr, size_t old_size, size_t new_size);
+// free region of size bytes
+void HugeAlloc_free(void *ptr, size_t size);
+
+// how many bytes are really reserved for a size bytes allocation
+#define HugeAlloc_round(size) (((size) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1))
+
+#endif /* A37D1CBB_AF30_4379_96F7_BBE9B965BD90 */
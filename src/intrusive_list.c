@@ -0,0 +1,288 @@
+#include "intrusive_list.h"
+#include <stdlib.h>
+
+#define unlinked(L) ((L)->next == NULL && (L)->prev == NULL)
+
+#ifdef CERB_DEBUG_LISTS
+
+// full scan, also catches links which belong to some other list
+static inline int in_list(IList *list, IListLink *link)
+{
+    IList_iter (list, first, next, cur) {
+        if (cur == link) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#else
+
+// O(1), link's neighbours ( or list's ends ) have to point back at it
+static inline int in_list(IList *list, IListLink *link)
+{
+    return (link->prev ? link->prev->next == link : list->first == link)
+        && (link->next ? link->next->prev == link : list->last == link);
+}
+
+#endif
+
+IList *IList_create(void)
+{
+    IList *list = calloc(1, sizeof(IList));
+    check_mem(list);
+
+    return list;
+
+error:
+    return NULL;
+}
+
+int IList_init(IList *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    list->first = NULL;
+    list->last = NULL;
+    list->count = 0;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int IList_destroy(IList **list)
+{
+    check(list != NULL, "Somehow got an address of the list that is NULL.");
+
+    free(*list);
+    *list = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* insert operations */
+
+int IList_push(IList *list, IListLink *link)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(link != NULL, "Somehow got link that is NULL.");
+    check(unlinked(link) && list->first != link, "Link %p is already in a list.", link);
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    link->prev = list->last;
+    if (list->last) {
+        list->last->next = link;
+    } else {
+        list->first = link;
+    }
+    list->last = link;
+    list->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int IList_unshift(IList *list, IListLink *link)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(link != NULL, "Somehow got link that is NULL.");
+    check(unlinked(link) && list->first != link, "Link %p is already in a list.", link);
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    link->next = list->first;
+    if (list->first) {
+        list->first->prev = link;
+    } else {
+        list->last = link;
+    }
+    list->first = link;
+    list->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int IList_insert_after(IList *list, IListLink *after, IListLink *link)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(after != NULL, "Somehow got after that is NULL.");
+
+    if (after == list->last) return IList_push(list, link);
+
+    check(link != NULL, "Somehow got link that is NULL.");
+    check(unlinked(link) && list->first != link, "Link %p is already in a list.", link);
+    check(in_list(list, after), "Couldn't find link %p in list.", after);
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    link->prev = after;
+    link->next = after->next;
+    after->next->prev = link;
+    after->next = link;
+    list->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int IList_insert_before(IList *list, IListLink *before, IListLink *link)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(before != NULL, "Somehow got before that is NULL.");
+
+    if (before == list->first) return IList_unshift(list, link);
+
+    check(link != NULL, "Somehow got link that is NULL.");
+    check(unlinked(link) && list->first != link, "Link %p is already in a list.", link);
+    check(in_list(list, before), "Couldn't find link %p in list.", before);
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    link->next = before;
+    link->prev = before->prev;
+    before->prev->next = link;
+    before->prev = link;
+    list->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* remove operations */
+
+IListLink *IList_remove(IList *list, IListLink *link)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(link != NULL, "Somehow got link that is NULL.");
+    check(list->count != 0 && in_list(list, link), "Couldn't find link %p in list.", link);
+
+    if (link->prev) {
+        link->prev->next = link->next;
+    } else {
+        list->first = link->next;
+    }
+
+    if (link->next) {
+        link->next->prev = link->prev;
+    } else {
+        list->last = link->prev;
+    }
+
+    IList_link_init(link); // so it can go in a list again
+    list->count--;
+
+    return link;
+
+error:
+    return NULL;
+}
+
+IListLink *IList_pop(IList *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    return list->last ? IList_remove(list, list->last) : NULL;
+
+error:
+    return NULL;
+}
+
+IListLink *IList_shift(IList *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    return list->first ? IList_remove(list, list->first) : NULL;
+
+error:
+    return NULL;
+}
+
+/* joining and splitting */
+
+int IList_join(IList *list1, IList *list2)
+{
+    check(list1 != NULL, "Somehow got list1 that is NULL.");
+    check(list2 != NULL, "Somehow got list2 that is NULL.");
+    check(list1 != list2, "Couldn't join list with itself.");
+    check((uint64_t) list1->count + list2->count <= UINT32_MAX,
+    "Couldn't join lists as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
+
+    if (!list2->count) return CERB_OK;
+
+    if (list1->last) {
+        list1->last->next = list2->first;
+        list2->first->prev = list1->last;
+    } else {
+        list1->first = list2->first;
+    }
+    list1->last = list2->last;
+    list1->count += list2->count;
+
+    IList_init(list2);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int IList_split(IList *list, IListLink *from_link, IListLink *to_link, IList *into)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(into != NULL && into->count == 0, "Couldn't split into a list that isn't empty.");
+    check(list != into, "Couldn't split list into itself.");
+
+    if (from_link == NULL) from_link = list->first;
+    if (to_link == NULL) to_link = list->last;
+
+    check(from_link != NULL, "Couldn't split an empty list.");
+    check(in_list(list, from_link), "Invalid from_link.");
+    check(in_list(list, to_link), "Invalid to_link.");
+
+    // count first, this also finds out if the links came in wrong order before anything is changed
+    uint32_t count = 1;
+    IListLink *cur = from_link;
+    for (; cur != to_link; cur = cur->next, count++) {
+        check(cur->next != NULL, "to_link comes before from_link.");
+    }
+
+    IListLink *before = from_link->prev;
+    IListLink *after = to_link->next;
+
+    if (before) {
+        before->next = after;
+    } else {
+        list->first = after;
+    }
+
+    if (after) {
+        after->prev = before;
+    } else {
+        list->last = before;
+    }
+
+    from_link->prev = NULL;
+    to_link->next = NULL;
+
+    into->first = from_link;
+    into->last = to_link;
+    into->count = count;
+    list->count -= count;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,91 @@
+#ifndef B631B0DA_08DC_4B9C_A6BD_98DFFDE99290
+#define B631B0DA_08DC_4B9C_A6BD_98DFFDE99290
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dbg.h"
+
+// put one of these in your own struct for every list it should be able to sit in
+// the list never allocates, it only links the structs you give it together
+// a link which isn't in any list has next and prev NULL ( zero it or IList_link_init it before first use )
+typedef struct IListLink {
+    struct IListLink *next;
+    struct IListLink *prev;
+} IListLink;
+
+// doubly linked list of links embedded in user structs ( kernel style intrusive list )
+// it can be embedded too, IList_init it instead of creating it
+typedef struct IList {
+    IListLink *first;
+    IListLink *last;
+    uint32_t count;
+} IList;
+
+// struct of type T which has link L in its member M
+#define IList_entry(L, T, M) ((T *) ((char *) (L) - offsetof(T, M)))
+
+#define IList_link_init(L) ((L)->next = (L)->prev = NULL)
+
+// create IList *list on the heap
+IList *IList_create(void);
+// make an embedded list empty
+int IList_init(IList *list);
+// free list ( THIS DOES NOT TOUCH THE STRUCTS IN IT ), pass a reference to make it NULL after freeing
+int IList_destroy(IList **list);
+
+// every call below is O(1) except split which counts what it moves
+// links which still point at neighbours are refused ( they are in some list already )
+// a link that's passed as position should be in list ( only checked in O(1) unless built with CERB_DEBUG_LISTS )
+
+// link at the end
+int IList_push(IList *list, IListLink *link);
+// unlink the last link and return it, NULL if list is empty
+IListLink *IList_pop(IList *list);
+// link at the front
+int IList_unshift(IList *list, IListLink *link);
+// unlink the first link and return it, NULL if list is empty
+IListLink *IList_shift(IList *list);
+// link after IListLink *after
+int IList_insert_after(IList *list, IListLink *after, IListLink *link);
+// link before IListLink *before
+int IList_insert_before(IList *list, IListLink *before, IListLink *link);
+// unlink link and return it, NULL if it isn't in list
+IListLink *IList_remove(IList *list, IListLink *link);
+// move every link of list2 to the end of list1, list2 stays empty ( and isn't freed, it may be embedded )
+int IList_join(IList *list1, IList *list2);
+// move links from from_link to to_link ( both included ) to the empty list into
+// NULL from_link means from first and NULL to_link means to last, always pass them from left to right
+int IList_split(IList *list, IListLink *from_link, IListLink *to_link, IList *into);
+
+#define IList_get_count(list) (list)->count
+
+// L is IList *list
+// S is starting link ( first or last ) D is direction ( next or prev )
+// C is current link's name you want it to have, it can be removed inside the loop
+#define IList_iter(L, S, D, C) IListLink *_link = NULL; IListLink *C = NULL;\
+        for (C = (L)->S; C != NULL && ((_link = C->D), 1); C = _link)
+
+// same as IList_iter but E is the struct of type T the current link sits in as member M
+#define IList_iter_entry(L, S, D, T, M, E) IListLink *_link = NULL; IListLink *_cur = NULL; T *E = NULL;\
+        for (_cur = (L)->S; _cur != NULL && ((_link = _cur->D), (E = IList_entry(_cur, T, M)), 1); _cur = _link)
+
+// list is IList *list
+// start is starting link ( first or last ) dir is direction ( next or prev )
+// T and M are the type of your struct and the member its link is in
+// cmp_func compares to_find with every struct and found is the variable name you want the found struct to be in
+#define IList_search(list, start, dir, T, M, cmp_func, to_find, found) T *found = NULL;\
+        if (list) {\
+            IList_iter_entry (list, start, dir, T, M, cur) {\
+                if (cmp_func(to_find, cur) == 0) {\
+                    found = cur;\
+                    break;\
+                }\
+            }\
+        } else {\
+            log_err("Somehow got list that is NULL.");\
+        }
+
+#endif /* B631B0DA_08DC_4B9C_A6BD_98DFFDE99290 */
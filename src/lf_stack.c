@@ -0,0 +1,285 @@
+#include "lf_stack.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* packing node pointer with its tag */
+
+#define LFSTACK_TAG_SHIFT 48
+#define LFSTACK_TAG_ONE ((uint64_t) 1 << LFSTACK_TAG_SHIFT)
+#define LFSTACK_POINTER_MASK (LFSTACK_TAG_ONE - 1)
+
+static inline LFStackNode *LFStack_node(uint64_t packed)
+{
+    return (LFStackNode *) (uintptr_t) (packed & LFSTACK_POINTER_MASK);
+}
+
+// same node or none with the next tag ( tag wraps around on its own )
+static inline uint64_t LFStack_pack(LFStackNode *node, uint64_t previous)
+{
+    return ((previous & ~LFSTACK_POINTER_MASK) + LFSTACK_TAG_ONE) | (uint64_t) (uintptr_t) node;
+}
+
+static _Thread_local uint64_t slot_seed = 0;
+
+// xorshift, colliding threads only need to be spread over the slots
+static inline uint64_t next_random(void)
+{
+    if (!slot_seed) slot_seed = (uint64_t) (uintptr_t) &slot_seed | 1;
+
+    slot_seed ^= slot_seed << 13;
+    slot_seed ^= slot_seed >> 7;
+    slot_seed ^= slot_seed << 17;
+
+    return slot_seed;
+}
+
+/* tagged stacks of nodes ( used for both top and spare ) */
+
+// link first..last in front of whatever head points to
+static inline void push_chain(_Atomic uint64_t *head, LFStackNode *first, LFStackNode *last)
+{
+    uint64_t old = atomic_load_explicit(head, memory_order_relaxed);
+
+    do {
+        atomic_store_explicit(&last->next, LFStack_node(old), memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(head, &old, LFStack_pack(first, old),
+                memory_order_release, memory_order_relaxed));
+}
+
+// one attempt, *empty tells a lost race apart from nothing to pop
+static inline LFStackNode *try_pop_node(_Atomic uint64_t *head, int *empty)
+{
+    uint64_t old = atomic_load_explicit(head, memory_order_acquire);
+    LFStackNode *node = LFStack_node(old);
+
+    *empty = node == NULL;
+    if (node == NULL) return NULL;
+
+    // node may already be popped and reused by now, that's fine, it's still a node and the CAS below fails
+    LFStackNode *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+    if (atomic_compare_exchange_strong_explicit(head, &old, LFStack_pack(next, old),
+                memory_order_acquire, memory_order_relaxed)) {
+        return node;
+    }
+
+    return NULL;
+}
+
+static inline LFStackNode *pop_node(_Atomic uint64_t *head)
+{
+    LFStackNode *node = NULL;
+    int empty = 0;
+
+    while (!(node = try_pop_node(head, &empty)) && !empty);
+
+    return node;
+}
+
+/* nodes */
+
+static LFStackNode *LFStack_slab_node(LFStack *stack)
+{
+    LFStackSlab *slab = NULL;
+    LFStackNode *node = NULL;
+    int locked = 0;
+
+    check(pthread_mutex_lock(&stack->slab_lock) == 0, "Failed to lock slab_lock.");
+    locked = 1;
+
+    // somebody else may have added a slab while we waited for the lock
+    node = pop_node(&stack->spare);
+    if (node == NULL) {
+        slab = malloc(sizeof(LFStackSlab));
+        check_mem(slab);
+        check(((uintptr_t) (slab + 1) & ~LFSTACK_POINTER_MASK) == 0, "Pointer doesn't fit in 48 bits.");
+
+        int i = 0;
+        for (i = 1; i < LFSTACK_SLAB_NODES - 1; i++) {
+            atomic_init(&slab->nodes[i].next, &slab->nodes[i + 1]);
+        }
+        atomic_init(&slab->nodes[0].next, NULL);
+
+        slab->next = stack->slabs;
+        stack->slabs = slab;
+        slab = NULL;
+
+        node = &stack->slabs->nodes[0];
+        push_chain(&stack->spare, &stack->slabs->nodes[1], &stack->slabs->nodes[LFSTACK_SLAB_NODES - 1]);
+    }
+
+    pthread_mutex_unlock(&stack->slab_lock);
+    return node;
+
+error:
+    free(slab);
+    if (locked) pthread_mutex_unlock(&stack->slab_lock);
+    return NULL;
+}
+
+static inline LFStackNode *LFStack_take_node(LFStack *stack)
+{
+    LFStackNode *node = pop_node(&stack->spare);
+
+    return node ? node : LFStack_slab_node(stack);
+}
+
+static inline void LFStack_give_node(LFStack *stack, LFStackNode *node)
+{
+    push_chain(&stack->spare, node, node);
+}
+
+/* elimination */
+
+// offer node in a random slot for a while, 1 if a popper took it
+static int eliminate_push(LFStack *stack, LFStackNode *node)
+{
+    _Atomic uint64_t *slot = &stack->slots[next_random() % LFSTACK_ELIMINATION_SLOTS];
+    uint64_t seen = atomic_load_explicit(slot, memory_order_relaxed);
+
+    if (LFStack_node(seen) != NULL) return 0;
+
+    uint64_t offer = LFStack_pack(node, seen);
+    if (!atomic_compare_exchange_strong_explicit(slot, &seen, offer, memory_order_release, memory_order_relaxed)) {
+        return 0;
+    }
+
+    int i = 0;
+    for (i = 0; i < LFSTACK_ELIMINATION_SPINS; i++) {
+        if (atomic_load_explicit(slot, memory_order_relaxed) != offer) return 1;
+    }
+
+    // a failed withdrawal means a popper got there first
+    return !atomic_compare_exchange_strong_explicit(slot, &offer, LFStack_pack(NULL, offer),
+            memory_order_relaxed, memory_order_relaxed);
+}
+
+// take a node some pusher is offering in a random slot, NULL if there's none
+static LFStackNode *eliminate_pop(LFStack *stack)
+{
+    _Atomic uint64_t *slot = &stack->slots[next_random() % LFSTACK_ELIMINATION_SLOTS];
+    uint64_t seen = atomic_load_explicit(slot, memory_order_acquire);
+    LFStackNode *node = LFStack_node(seen);
+
+    if (node && atomic_compare_exchange_strong_explicit(slot, &seen, LFStack_pack(NULL, seen),
+                memory_order_acquire, memory_order_relaxed)) {
+        return node;
+    }
+
+    return NULL;
+}
+
+/* stack */
+
+LFStack *LFStack_create(void)
+{
+    LFStack *stack = aligned_alloc(64, sizeof(LFStack));
+    check_mem(stack);
+    memset(stack, 0, sizeof(LFStack));
+
+    atomic_init(&stack->top, 0);
+    atomic_init(&stack->spare, 0);
+
+    int i = 0;
+    for (i = 0; i < LFSTACK_ELIMINATION_SLOTS; i++) {
+        atomic_init(&stack->slots[i], 0);
+    }
+
+    check(pthread_mutex_init(&stack->slab_lock, NULL) == 0, "Failed to initialize slab_lock.");
+    stack->slabs = NULL;
+
+    return stack;
+
+error:
+    free(stack);
+    return NULL;
+}
+
+int LFStack_push(LFStack *stack, void *data)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+    check(data != NULL, "Can't push NULL.");
+
+    LFStackNode *node = LFStack_take_node(stack);
+    check(node != NULL, "Failed to get a node.");
+
+    node->data = data;
+
+    uint64_t old = atomic_load_explicit(&stack->top, memory_order_relaxed);
+    for (;;) {
+        atomic_store_explicit(&node->next, LFStack_node(old), memory_order_relaxed);
+        if (atomic_compare_exchange_strong_explicit(&stack->top, &old, LFStack_pack(node, old),
+                    memory_order_release, memory_order_relaxed)) {
+            return CERB_OK;
+        }
+
+        // top is contended, try handing the node straight to a popper instead
+        if (eliminate_push(stack, node)) return CERB_OK;
+
+        old = atomic_load_explicit(&stack->top, memory_order_relaxed);
+    }
+
+error:
+    return CERB_ERR;
+}
+
+void *LFStack_pop(LFStack *stack)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+
+    LFStackNode *node = NULL;
+    int empty = 0;
+
+    for (;;) {
+        if ((node = try_pop_node(&stack->top, &empty))) break;
+        if (empty) return NULL;
+
+        // top is contended, maybe a pusher is waiting in a slot
+        if ((node = eliminate_pop(stack))) break;
+    }
+
+    void *data = node->data;
+    LFStack_give_node(stack, node);
+
+    return data;
+
+error:
+    return NULL;
+}
+
+int LFStack_destroy(LFStack **stack)
+{
+    check(stack != NULL, "Somehow got reference to stack that is NULL.");
+    check(*stack != NULL, "Somehow got stack that is NULL.");
+
+    LFStackSlab *slab = (*stack)->slabs;
+    while (slab) {
+        LFStackSlab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    pthread_mutex_destroy(&(*stack)->slab_lock);
+    free(*stack);
+    *stack = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int LFStack_free_complex_data(LFStack **stack, free_func handler_func)
+{
+    check(stack != NULL && *stack != NULL, "Somehow got stack that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    void *data = NULL;
+    while ((data = LFStack_pop(*stack))) {
+        handler_func(data);
+    }
+
+    return LFStack_destroy(stack);
+
+error:
+    return CERB_ERR;
+}
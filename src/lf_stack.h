@@ -0,0 +1,61 @@
+#ifndef D15A123D_6BF2_45D6_882E_249F81573A25
+#define D15A123D_6BF2_45D6_882E_249F81573A25
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "dbg.h"
+
+typedef void (*free_func) (void *data);
+
+// nodes are carved out of slabs of this many, a slab is only allocated when every node is in use
+#define LFSTACK_SLAB_NODES 256
+// slots pushers and poppers that lost a CAS on top can meet in and cancel out
+#define LFSTACK_ELIMINATION_SLOTS 16
+// how long a pusher waits in a slot for a popper before it goes back to top
+#define LFSTACK_ELIMINATION_SPINS 128
+
+typedef struct LFStackNode {
+    _Atomic(struct LFStackNode *) next;
+    void *data;
+} LFStackNode;
+
+typedef struct LFStackSlab {
+    struct LFStackSlab *next;
+    LFStackNode nodes[LFSTACK_SLAB_NODES];
+} LFStackSlab;
+
+// stack any number of threads can push to and pop from without locks ( Treiber stack )
+// top, spare and slots hold a node pointer in the low 48 bits and a tag in the high 16 bits,
+// the tag changes with every CAS so a node which got popped and pushed again in between doesn't fool anyone ( ABA )
+// nodes are never freed before the stack is, popped ones go to spare and get reused,
+// so reading next of a node somebody else just popped is always safe ( no hazard pointers or epochs needed )
+typedef struct LFStack {
+    _Alignas(64) _Atomic uint64_t top;
+    _Alignas(64) _Atomic uint64_t spare; // free nodes, same tagged scheme as top
+    _Alignas(64) _Atomic uint64_t slots[LFSTACK_ELIMINATION_SLOTS]; // node a pusher offers to poppers, 0 if none
+    _Alignas(64) pthread_mutex_t slab_lock; // only taken to allocate a slab
+    LFStackSlab *slabs;
+} LFStack;
+
+LFStack *LFStack_create(void);
+
+// push data ( it can't be NULL, NULL is what pop returns when stack is empty )
+int LFStack_push(LFStack *stack, void *data);
+// pop the newest element, NULL if the stack is empty
+void *LFStack_pop(LFStack *stack);
+
+// free the stack ( THIS DOES NOT FREE THE DATA IN IT ), nobody should be using it anymore
+// pass a reference to make it NULL after freeing
+int LFStack_destroy(LFStack **stack);
+// call handler_func on every element still in the stack and then free the stack
+int LFStack_free_complex_data(LFStack **stack, free_func handler_func);
+
+// stack is empty right now ( only a hint while others push and pop )
+#define LFStack_is_empty(S) ((atomic_load_explicit(&(S)->top, memory_order_relaxed) & (((uint64_t) 1 << 48) - 1)) == 0)
+
+#endif /* D15A123D_6BF2_45D6_882E_249F81573A25 */
@@ -0,0 +1,292 @@
+#define _GNU_SOURCE // mremap, MAP_POPULATE
+#include "mapped_darray.h"
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+static inline size_t MappedDArray_file_size(size_t element_size, size_t capacity)
+{
+    return sizeof(MappedDArrayHeader) + element_size * capacity;
+}
+
+// map the first size bytes of array->fd and point header and contents into it
+static int MappedDArray_map(MappedDArray *array, size_t size)
+{
+    int map_flags = MAP_SHARED | (array->flags & MAPPED_DARRAY_POPULATE ? MAP_POPULATE : 0);
+
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, map_flags, array->fd, 0);
+    check(mapping != MAP_FAILED, "Couldn't map the file.");
+
+    array->header = mapping;
+    array->contents = (uint8_t *) mapping + sizeof(MappedDArrayHeader);
+    array->mapped_size = size;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* create and open operations */
+
+MappedDArray *MappedDArray_create(const char *path, size_t element_size, size_t initial_capacity, int flags)
+{
+    MappedDArray *array = NULL;
+
+    check(path != NULL, "Somehow got path that is NULL.");
+    check(element_size != 0, "Couldn't make 0 element sized array.");
+
+    array = calloc(1, sizeof(MappedDArray));
+    check_mem(array);
+    array->fd = -1;
+
+    array->flags = flags;
+    array->element_size = element_size;
+    array->capacity = initial_capacity;
+
+    array->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    check(array->fd != -1, "Couldn't create file %s.", path);
+
+    size_t size = MappedDArray_file_size(element_size, initial_capacity);
+    check(ftruncate(array->fd, (off_t) size) == 0, "Couldn't size file %s.", path);
+
+    int rc = MappedDArray_map(array, size);
+    check(rc != CERB_ERR, "Couldn't map file %s.", path);
+
+    array->header->magic = MAPPED_DARRAY_MAGIC;
+    array->header->element_size = element_size;
+    array->header->length = 0;
+
+    return array;
+
+error:
+    if (array) {
+        if (array->fd != -1) close(array->fd);
+        free(array);
+    }
+    return NULL;
+}
+
+MappedDArray *MappedDArray_open(const char *path, int flags)
+{
+    MappedDArray *array = NULL;
+    MappedDArrayHeader header;
+
+    check(path != NULL, "Somehow got path that is NULL.");
+
+    array = calloc(1, sizeof(MappedDArray));
+    check_mem(array);
+    array->fd = -1;
+
+    array->flags = flags;
+
+    array->fd = open(path, O_RDWR);
+    check(array->fd != -1, "Couldn't open file %s.", path);
+
+    struct stat info;
+    check(fstat(array->fd, &info) == 0, "Couldn't stat file %s.", path);
+    check((size_t) info.st_size >= sizeof(MappedDArrayHeader), "File %s is too small to be an array.", path);
+
+    check(pread(array->fd, &header, sizeof(header), 0) == sizeof(header), "Couldn't read header of %s.", path);
+    check(header.magic == MAPPED_DARRAY_MAGIC, "File %s isn't an array.", path);
+    check(header.element_size != 0, "File %s has 0 element size.", path);
+
+    array->element_size = header.element_size;
+    array->capacity = ((size_t) info.st_size - sizeof(MappedDArrayHeader)) / header.element_size;
+    check(header.length <= array->capacity, "File %s is shorter than its length.", path);
+
+    int rc = MappedDArray_map(array, MappedDArray_file_size(array->element_size, array->capacity));
+    check(rc != CERB_ERR, "Couldn't map file %s.", path);
+
+    return array;
+
+error:
+    if (array) {
+        if (array->fd != -1) close(array->fd);
+        free(array);
+    }
+    return NULL;
+}
+
+/* resize operations */
+
+int MappedDArray_reserve(MappedDArray *array, size_t capacity)
+{
+    int grown = 0;
+
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    if (capacity <= array->capacity) return CERB_OK;
+
+    check(capacity <= (SIZE_MAX - sizeof(MappedDArrayHeader)) / array->element_size,
+            "Capacity %zu is too big for records of %zu bytes.", capacity, array->element_size);
+    size_t size = MappedDArray_file_size(array->element_size, capacity);
+    check((off_t) size > 0, "File of %zu bytes is too big.", size);
+
+    check(ftruncate(array->fd, (off_t) size) == 0, "Couldn't grow the file, array hasn't been changed.");
+    grown = 1;
+
+#ifdef __linux__
+    void *mapping = mremap(array->header, array->mapped_size, size, MREMAP_MAYMOVE);
+    check(mapping != MAP_FAILED, "Couldn't grow the mapping, array hasn't been changed.");
+
+    array->header = mapping;
+    array->contents = (uint8_t *) mapping + sizeof(MappedDArrayHeader);
+    array->mapped_size = size;
+
+    if (array->flags & MAPPED_DARRAY_POPULATE) {
+        madvise(mapping, size, MADV_WILLNEED);
+    }
+#else
+    // no mremap here, so we map the grown file from scratch
+    void *old_mapping = array->header;
+    size_t old_size = array->mapped_size;
+
+    int rc = MappedDArray_map(array, size);
+    check(rc != CERB_ERR, "Couldn't grow the mapping, array hasn't been changed.");
+    munmap(old_mapping, old_size);
+#endif
+
+    array->capacity = capacity;
+
+    return CERB_OK;
+
+error:
+    // the mapping stayed as it was, so the file goes back to the size it matches
+    if (grown && ftruncate(array->fd, (off_t) MappedDArray_file_size(array->element_size, array->capacity)) != 0) {
+        log_warn("Couldn't shrink the file back, it's bigger than the array until the next reserve.");
+    }
+    return CERB_ERR;
+}
+
+/* pushing and popping */
+
+int MappedDArray_push(MappedDArray *array, const void *record)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(record != NULL, "Somehow got record that is NULL.");
+
+    size_t length = array->header->length;
+
+    if (length == array->capacity) {
+        // grow geometrically, every growth is a syscall and may move gigabytes of mapping
+        int rc = MappedDArray_reserve(array, array->capacity ? array->capacity * 2 : 64);
+        check(rc != CERB_ERR, "Couldn't expand array, you won't be able insert past current length.");
+    }
+
+    memcpy(array->contents + length * array->element_size, record, array->element_size);
+    array->header->length = length + 1;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int MappedDArray_pop(MappedDArray *array, void *out)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(array->header->length > 0, "Couldn't pop from empty array.");
+
+    size_t length = array->header->length - 1;
+
+    if (out) {
+        memcpy(out, array->contents + length * array->element_size, array->element_size);
+    }
+    array->header->length = length;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int MappedDArray_set(MappedDArray *array, size_t i, const void *record)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(record != NULL, "Somehow got record that is NULL.");
+    check(i < array->header->length, "Couldn't set element number that hasn't been added to list previously.");
+
+    memcpy(array->contents + i * array->element_size, record, array->element_size);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* paging hints and syncing */
+
+int MappedDArray_advise(MappedDArray *array, int advice)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    int madv = MADV_NORMAL;
+    switch (advice) {
+        case MAPPED_DARRAY_NORMAL:
+            madv = MADV_NORMAL;
+            break;
+        case MAPPED_DARRAY_SEQUENTIAL:
+            madv = MADV_SEQUENTIAL;
+            break;
+        case MAPPED_DARRAY_RANDOM:
+            madv = MADV_RANDOM;
+            break;
+        case MAPPED_DARRAY_WILLNEED:
+            madv = MADV_WILLNEED;
+            break;
+        default:
+            sentinel("Invalid advice %d.", advice);
+    }
+
+    check(madvise(array->header, array->mapped_size, madv) == 0, "Couldn't advise the kernel.");
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int MappedDArray_sync(MappedDArray *array)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    check(msync(array->header, array->mapped_size, MS_SYNC) == 0, "Couldn't sync the array.");
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* closing */
+
+int MappedDArray_close(MappedDArray **array)
+{
+    check(array != NULL, "Somehow got address of array that is NULL.");
+    check(*array != NULL, "Somehow got array that is NULL.");
+
+    size_t size = MappedDArray_file_size((*array)->element_size, (*array)->header->length);
+
+    munmap((*array)->header, (*array)->mapped_size);
+    // spare capacity isn't worth keeping on disk, open will size the array from what's left
+    if (ftruncate((*array)->fd, (off_t) size) != 0) {
+        log_warn("Couldn't trim the file, it keeps its spare capacity.");
+    }
+    close((*array)->fd);
+
+    free(*array);
+    *array = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
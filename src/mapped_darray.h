@@ -0,0 +1,77 @@
+#ifndef A9F2C55C_2B9B_4BA3_97CA_76B1CD995B9B
+#define A9F2C55C_2B9B_4BA3_97CA_76B1CD995B9B
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dbg.h"
+
+// flags for create and open
+// prefault the whole mapping when it's made instead of paging it in lazily
+#define MAPPED_DARRAY_POPULATE 1
+
+// access hints for MappedDArray_advise
+#define MAPPED_DARRAY_NORMAL 0
+#define MAPPED_DARRAY_SEQUENTIAL 1
+#define MAPPED_DARRAY_RANDOM 2
+#define MAPPED_DARRAY_WILLNEED 3
+
+#define MAPPED_DARRAY_MAGIC 0x31414442524543ULL // "CERBDA1"
+
+// first bytes of the file, records follow right after it
+typedef struct MappedDArrayHeader {
+    uint64_t magic;
+    uint64_t element_size;
+    uint64_t length;
+    uint64_t reserved[5]; // pads header to 64 bytes so records start cache line aligned
+} MappedDArrayHeader;
+
+// array of fixed size records ( copied in, not pointers ) living in a file mapped into memory
+// length is kept in the file header, so reopening an array is instant and pages get read lazily
+typedef struct MappedDArray {
+    int fd;
+    int flags;
+    size_t element_size;
+    size_t capacity; // how many records fit in the file right now
+    size_t mapped_size; // bytes mapped, header included
+    MappedDArrayHeader *header;
+    uint8_t *contents;
+} MappedDArray;
+
+// create ( or truncate ) file at path and map it, element_size is size of one record in bytes
+MappedDArray *MappedDArray_create(const char *path, size_t element_size, size_t initial_capacity, int flags);
+// map array which was made by MappedDArray_create earlier
+MappedDArray *MappedDArray_open(const char *path, int flags);
+// grow file and mapping to fit at least capacity records
+// growing may move the mapping, so pointers from MappedDArray_get become invalid
+int MappedDArray_reserve(MappedDArray *array, size_t capacity);
+// copy record at the end of an array ( grows file by doubling when full )
+int MappedDArray_push(MappedDArray *array, const void *record);
+// copy last record into out ( if out isn't NULL ) and remove it
+int MappedDArray_pop(MappedDArray *array, void *out);
+// copy record over the one at position i
+int MappedDArray_set(MappedDArray *array, size_t i, const void *record);
+// tell the kernel how you are going to access the array ( MAPPED_DARRAY_SEQUENTIAL, RANDOM ... )
+int MappedDArray_advise(MappedDArray *array, int advice);
+// write dirty pages back to the file and wait for it
+int MappedDArray_sync(MappedDArray *array);
+// unmap array, trim the file to its length and close it ( pass a reference to make it NULL )
+int MappedDArray_close(MappedDArray **array);
+
+#define MappedDArray_length(A) ((A)->header->length)
+
+// pointer to the record at position i, valid until the array grows or gets closed
+static inline void *MappedDArray_get(MappedDArray *array, size_t i)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(i < array->header->length, "Couldn't get element number that hasn't been added to list previously.");
+
+    return array->contents + i * array->element_size;
+
+error:
+    return NULL;
+}
+
+#endif /* A9F2C55C_2B9B_4BA3_97CA_76B1CD995B9B */
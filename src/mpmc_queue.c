@@ -0,0 +1,277 @@
+#include "mpmc_queue.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+// pops a consumer retries before it goes to sleep, most waits are shorter than a futex round trip
+#define MPMC_SPINS 64
+
+/* sleeping */
+
+#ifdef __linux__
+
+static inline void futex_wait(atomic_uint *word, unsigned int expected)
+{
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static inline void futex_wake(atomic_uint *word, int count)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+#else
+
+// no futexes, sleepers just give their CPU away and look again
+static inline void futex_wait(atomic_uint *word, unsigned int expected)
+{
+    (void) word;
+    (void) expected;
+    sched_yield();
+}
+
+static inline void futex_wake(atomic_uint *word, int count)
+{
+    (void) word;
+    (void) count;
+}
+
+#endif
+
+// producers look at sleepers after their push is visible, a consumer registers itself before its last look,
+// so with the fences in between either the producer sees the sleeper or the sleeper sees the element
+static inline void wake_consumers(MPMCQueue *queue, int count)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(&queue->sleepers, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&queue->wakeups, 1, memory_order_release);
+        futex_wake(&queue->wakeups, count);
+    }
+}
+
+/* create */
+
+MPMCQueue *MPMCQueue_create(size_t capacity)
+{
+    MPMCQueue *queue = NULL;
+
+    check(capacity > 0 && capacity <= ((size_t) 1 << 40), "Capacity %zu is out of range.", capacity);
+
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    queue = aligned_alloc(64, sizeof(MPMCQueue));
+    check_mem(queue);
+    memset(queue, 0, sizeof(MPMCQueue));
+
+    queue->mask = size - 1;
+    // aligned_alloc wants a multiple of the alignment, small queues are less than a cache line of cells
+    queue->cells = aligned_alloc(64, (sizeof(MPMCCell) * size + 63) & ~(size_t) 63);
+    check_mem(queue->cells);
+
+    size_t i = 0;
+    for (i = 0; i < size; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+        queue->cells[i].data = NULL;
+    }
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->wakeups, 0);
+    atomic_init(&queue->sleepers, 0);
+    atomic_init(&queue->closed, 0);
+
+    return queue;
+
+error:
+    if (queue) free(queue);
+    return NULL;
+}
+
+/* push and pop */
+
+int MPMCQueue_try_push_many(MPMCQueue *queue, void **data, int count)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(data != NULL || count == 0, "Somehow got data that is NULL.");
+    check(count >= 0, "Count can't be negative.");
+
+    if (count == 0) return 0;
+
+    // pops return NULL for an empty queue, so a NULL element couldn't be told apart from nothing
+    size_t i = 0;
+    for (i = 0; i < (size_t) count; i++) {
+        check(data[i] != NULL, "Element %zu is NULL.", i);
+    }
+
+    size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t free_cells = 0;
+
+    for (;;) {
+        // count free cells from position on, nobody else can fill them until tail moves past them
+        for (free_cells = 0; free_cells < (size_t) count; free_cells++) {
+            MPMCCell *cell = &queue->cells[(position + free_cells) & queue->mask];
+            if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + free_cells) break;
+        }
+
+        if (free_cells == 0) {
+            size_t sequence = atomic_load_explicit(&queue->cells[position & queue->mask].sequence, memory_order_acquire);
+            // cell still holds an element from one lap ago, the queue is full
+            if ((intptr_t) (sequence - position) < 0) return 0;
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + free_cells,
+                    memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    for (i = 0; i < free_cells; i++) {
+        MPMCCell *cell = &queue->cells[(position + i) & queue->mask];
+        cell->data = data[i];
+        atomic_store_explicit(&cell->sequence, position + i + 1, memory_order_release);
+    }
+
+    wake_consumers(queue, (int) free_cells);
+
+    return (int) free_cells;
+
+error:
+    return CERB_ERR;
+}
+
+int MPMCQueue_try_pop_many(MPMCQueue *queue, void **out, int count)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(out != NULL || count == 0, "Somehow got out that is NULL.");
+    check(count >= 0, "Count can't be negative.");
+
+    if (count == 0) return 0;
+
+    size_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t full_cells = 0;
+
+    for (;;) {
+        for (full_cells = 0; full_cells < (size_t) count; full_cells++) {
+            MPMCCell *cell = &queue->cells[(position + full_cells) & queue->mask];
+            if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + full_cells + 1) break;
+        }
+
+        if (full_cells == 0) {
+            size_t sequence = atomic_load_explicit(&queue->cells[position & queue->mask].sequence, memory_order_acquire);
+            // cell wasn't filled for this lap yet, the queue is empty
+            if ((intptr_t) (sequence - (position + 1)) < 0) return 0;
+            position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&queue->head, &position, position + full_cells,
+                    memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    size_t i = 0;
+    for (i = 0; i < full_cells; i++) {
+        MPMCCell *cell = &queue->cells[(position + i) & queue->mask];
+        out[i] = cell->data;
+        // free for the producer one lap ahead
+        atomic_store_explicit(&cell->sequence, position + i + queue->mask + 1, memory_order_release);
+    }
+
+    return (int) full_cells;
+
+error:
+    return CERB_ERR;
+}
+
+int MPMCQueue_try_push(MPMCQueue *queue, void *data)
+{
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    int pushed = MPMCQueue_try_push_many(queue, &data, 1);
+
+    return pushed == 1 ? CERB_OK : CERB_ERR;
+
+error:
+    return CERB_ERR;
+}
+
+void *MPMCQueue_try_pop(MPMCQueue *queue)
+{
+    void *data = NULL;
+
+    return MPMCQueue_try_pop_many(queue, &data, 1) == 1 ? data : NULL;
+}
+
+void *MPMCQueue_pop_wait(MPMCQueue *queue)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    int spins = 0;
+    for (;;) {
+        void *data = MPMCQueue_try_pop(queue);
+        if (data) return data;
+
+        if (spins++ < MPMC_SPINS) continue;
+
+        atomic_fetch_add_explicit(&queue->sleepers, 1, memory_order_seq_cst);
+        unsigned int wakeups = atomic_load_explicit(&queue->wakeups, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        data = MPMCQueue_try_pop(queue);
+        if (!data && !atomic_load_explicit(&queue->closed, memory_order_acquire)) {
+            futex_wait(&queue->wakeups, wakeups);
+        }
+        atomic_fetch_sub_explicit(&queue->sleepers, 1, memory_order_relaxed);
+
+        if (data) return data;
+        if (atomic_load_explicit(&queue->closed, memory_order_acquire)) {
+            // pushes which finished before close are still handed out
+            return MPMCQueue_try_pop(queue);
+        }
+        spins = 0;
+    }
+
+error:
+    return NULL;
+}
+
+int MPMCQueue_close(MPMCQueue *queue)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    atomic_store_explicit(&queue->closed, 1, memory_order_release);
+    atomic_fetch_add_explicit(&queue->wakeups, 1, memory_order_release);
+    futex_wake(&queue->wakeups, INT_MAX);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int MPMCQueue_destroy(MPMCQueue **queue)
+{
+    check(queue != NULL, "Somehow got reference to queue that is NULL.");
+    check(*queue != NULL, "Somehow got queue that is NULL.");
+
+    free((*queue)->cells);
+    free(*queue);
+    *queue = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
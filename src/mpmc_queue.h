@@ -0,0 +1,58 @@
+#ifndef EBFA19CF_A8F7_442B_8427_83A11A734753
+#define EBFA19CF_A8F7_442B_8427_83A11A734753
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dbg.h"
+
+// every cell carries a sequence number which says whose turn it is:
+// position p is free for the producer of p when sequence == p and full for the consumer of p when sequence == p + 1
+typedef struct MPMCCell {
+    atomic_size_t sequence;
+    void *data;
+} MPMCCell;
+
+// bounded queue any number of threads can push to and pop from without locks
+// producers and consumers only meet on the cells they claim, tail and head sit on their own cache lines
+typedef struct MPMCQueue {
+    _Alignas(64) atomic_size_t tail; // next position to push to
+    _Alignas(64) atomic_size_t head; // next position to pop from
+    _Alignas(64) atomic_uint wakeups; // futex word, bumped whenever sleeping consumers should look again
+    atomic_uint sleepers;
+    atomic_int closed;
+    _Alignas(64) size_t mask;
+    MPMCCell *cells;
+} MPMCQueue;
+
+// create a queue with room for capacity elements ( rounded up to a power of two )
+MPMCQueue *MPMCQueue_create(size_t capacity);
+
+// push data, CERB_ERR if the queue is full
+int MPMCQueue_try_push(MPMCQueue *queue, void *data);
+// pop the oldest element, NULL if the queue is empty
+void *MPMCQueue_try_pop(MPMCQueue *queue);
+// push as many of count elements as fit with one claim and return how many got pushed ( in order )
+// none of them can be NULL, CERB_ERR and nothing pushed if one is
+int MPMCQueue_try_push_many(MPMCQueue *queue, void **data, int count);
+// pop up to count elements with one claim into out and return how many got popped ( oldest first )
+int MPMCQueue_try_pop_many(MPMCQueue *queue, void **out, int count);
+
+// pop the oldest element, sleeping ( on a futex, no spinning ) while the queue is empty
+// returns NULL only once the queue is closed and empty
+void *MPMCQueue_pop_wait(MPMCQueue *queue);
+// no more pushes are coming, every consumer sleeping in pop_wait wakes up
+int MPMCQueue_close(MPMCQueue *queue);
+
+// free the queue ( THIS DOES NOT FREE THE DATA IN IT ), nobody should be using it anymore
+// pass a reference to make it NULL after freeing
+int MPMCQueue_destroy(MPMCQueue **queue);
+
+// elements in the queue right now ( only a hint while others push and pop )
+#define MPMCQueue_length(Q) (atomic_load_explicit(&(Q)->tail, memory_order_relaxed)\
+        - atomic_load_explicit(&(Q)->head, memory_order_relaxed))
+
+#endif /* EBFA19CF_A8F7_442B_8427_83A11A734753 */
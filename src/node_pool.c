@@ -0,0 +1,107 @@
+#include "node_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+// slab header is padded so nodes after it stay aligned like malloc'd memory
+#define NODE_POOL_HEADER ((sizeof(NodePoolSlab) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+NodePool *NodePool_create(size_t node_size, uint32_t slab_nodes)
+{
+    check(node_size > 0, "Node size can't be 0.");
+
+    NodePool *pool = calloc(1, sizeof(NodePool));
+    check_mem(pool);
+
+    // every node has to fit the free list link and keep the next node pointer aligned
+    if (node_size < sizeof(void *)) node_size = sizeof(void *);
+    pool->node_size = (node_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    pool->slab_nodes = slab_nodes ? slab_nodes : NODE_POOL_SLAB_NODES;
+    pool->users = 1;
+
+    return pool;
+
+error:
+    return NULL;
+}
+
+NodePool *NodePool_retain(NodePool *pool)
+{
+    check(pool != NULL, "Somehow got pool that is NULL.");
+    check(pool->users < UINT32_MAX, "Pool has too many users.");
+
+    pool->users++;
+    return pool;
+
+error:
+    return NULL;
+}
+
+int NodePool_release(NodePool **pool)
+{
+    check(pool != NULL, "Somehow got reference to pool that is NULL.");
+    check(*pool != NULL, "Somehow got pool that is NULL.");
+
+    if (--(*pool)->users == 0) {
+        NodePoolSlab *slab = (*pool)->slabs;
+        while (slab) {
+            NodePoolSlab *next = slab->next;
+            free(slab);
+            slab = next;
+        }
+        free(*pool);
+    }
+    *pool = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+static int NodePool_grow(NodePool *pool)
+{
+    NodePoolSlab *slab = malloc(NODE_POOL_HEADER + pool->node_size * pool->slab_nodes);
+    check_mem(slab);
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+
+    // nodes are handed out from the start of the slab on demand, nothing is threaded up front
+    pool->unused = (char *) slab + NODE_POOL_HEADER;
+    pool->unused_end = pool->unused + pool->node_size * pool->slab_nodes;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *NodePool_alloc(NodePool *pool)
+{
+    void *node = NULL;
+
+    check(pool != NULL, "Somehow got pool that is NULL.");
+
+    if (pool->free_nodes) {
+        node = pool->free_nodes;
+        pool->free_nodes = *(void **) node;
+    } else {
+        if (pool->unused == pool->unused_end) {
+            check(NodePool_grow(pool) != CERB_ERR, "Failed to grow pool.");
+        }
+        node = pool->unused;
+        pool->unused += pool->node_size;
+    }
+
+    memset(node, 0, pool->node_size);
+
+error: // fall through
+    return node;
+}
+
+void NodePool_free(NodePool *pool, void *node)
+{
+    *(void **) node = pool->free_nodes;
+    pool->free_nodes = node;
+}
@@ -0,0 +1,50 @@
+#ifndef B12A4D2F_1918_4503_8CA2_924E74BFFB26
+#define B12A4D2F_1918_4503_8CA2_924E74BFFB26
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dbg.h"
+
+// nodes per slab when you pass 0 to NodePool_create
+#define NODE_POOL_SLAB_NODES 256
+
+typedef struct NodePoolSlab {
+    struct NodePoolSlab *next;
+} NodePoolSlab; // nodes follow right after this header
+
+// hands out fixed size nodes carved from slabs, freed nodes go on a free list and get handed out again
+// so once the pool is warm nothing goes through malloc
+// memory only goes back to the system when the last user releases the pool, then whole slabs are freed
+// pools aren't thread safe, lists sharing one should be used from one thread at a time
+typedef struct NodePool {
+    size_t node_size;
+    uint32_t slab_nodes;
+    uint32_t users; // reference count, the one who creates the pool is the first user
+    void *free_nodes; // freed nodes, linked through their first word
+    char *unused; // next never handed out node in the newest slab
+    char *unused_end;
+    NodePoolSlab *slabs;
+    size_t slab_count;
+} NodePool;
+
+// create a pool of node_size byte nodes, slab_nodes at a time ( 0 for NODE_POOL_SLAB_NODES )
+NodePool *NodePool_create(size_t node_size, uint32_t slab_nodes);
+
+// one more user ( e.g. a list ) shares the pool
+NodePool *NodePool_retain(NodePool *pool);
+// user is done with the pool, the last one frees every slab ( nodes still in use go with them )
+// pass a reference to make it NULL after releasing
+int NodePool_release(NodePool **pool);
+
+// zeroed node, NULL if a new slab was needed and couldn't be allocated
+void *NodePool_alloc(NodePool *pool);
+// give node back to the pool it came from
+void NodePool_free(NodePool *pool, void *node);
+
+// pool is only used by whoever asks, so it can be released without giving nodes back one by one
+#define NodePool_sole_user(P) ((P)->users == 1)
+
+#endif /* B12A4D2F_1918_4503_8CA2_924E74BFFB26 */
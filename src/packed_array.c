@@ -0,0 +1,333 @@
+#include "packed_array.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PACKED_X86 1
+#include <immintrin.h>
+#endif
+
+// differences k, k + 4, k + 8 ... go to lane k % 4, lane words are interleaved ( word n of lane l is at 4 * n + l )
+// so the same shift and mask apply to 4 neighbouring words at every step
+#define LANE_VALUES (PACKED_ARRAY_BLOCK / PACKED_ARRAY_LANES)
+
+typedef void (*unpack_func) (const uint64_t *words, int width, uint64_t *out);
+
+static inline uint64_t width_mask(int width)
+{
+    return width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;
+}
+
+static void pack_block(const uint64_t *deltas, int width, uint64_t *words)
+{
+    int k = 0;
+    memset(words, 0, sizeof(uint64_t) * PACKED_ARRAY_LANES * width);
+
+    for (k = 0; k < PACKED_ARRAY_BLOCK; k++) {
+        int lane = k % PACKED_ARRAY_LANES;
+        int bit = (k / PACKED_ARRAY_LANES) * width;
+        int word = bit >> 6, shift = bit & 63;
+
+        words[PACKED_ARRAY_LANES * word + lane] |= deltas[k] << shift;
+        if (shift + width > 64) {
+            words[PACKED_ARRAY_LANES * (word + 1) + lane] |= deltas[k] >> (64 - shift);
+        }
+    }
+}
+
+static void unpack_scalar(const uint64_t *words, int width, uint64_t *out)
+{
+    uint64_t mask = width_mask(width);
+    int j = 0, lane = 0;
+
+    for (j = 0; j < LANE_VALUES; j++) {
+        int bit = j * width;
+        const uint64_t *low = words + PACKED_ARRAY_LANES * (bit >> 6);
+        int shift = bit & 63;
+
+        for (lane = 0; lane < PACKED_ARRAY_LANES; lane++) {
+            uint64_t value = low[lane] >> shift;
+            if (shift + width > 64) {
+                value |= low[PACKED_ARRAY_LANES + lane] << (64 - shift);
+            }
+            out[PACKED_ARRAY_LANES * j + lane] = value & mask;
+        }
+    }
+}
+
+#ifdef PACKED_X86
+
+__attribute__((target("avx2")))
+static void unpack_avx2(const uint64_t *words, int width, uint64_t *out)
+{
+    __m256i mask = _mm256_set1_epi64x((long long) width_mask(width));
+    int j = 0;
+
+    for (j = 0; j < LANE_VALUES; j++) {
+        int bit = j * width;
+        const uint64_t *low = words + PACKED_ARRAY_LANES * (bit >> 6);
+        int shift = bit & 63;
+
+        __m256i value = _mm256_srl_epi64(_mm256_loadu_si256((const __m256i *) low), _mm_cvtsi32_si128(shift));
+        if (shift + width > 64) {
+            __m256i high = _mm256_loadu_si256((const __m256i *) (low + PACKED_ARRAY_LANES));
+            value = _mm256_or_si256(value, _mm256_sll_epi64(high, _mm_cvtsi32_si128(64 - shift)));
+        }
+        _mm256_storeu_si256((__m256i *) (out + PACKED_ARRAY_LANES * j), _mm256_and_si256(value, mask));
+    }
+}
+
+#endif /* PACKED_X86 */
+
+static unpack_func unpack_kernel = unpack_scalar;
+
+__attribute__((constructor))
+static void PackedArray_select_kernel(void)
+{
+#ifdef PACKED_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        unpack_kernel = unpack_avx2;
+    }
+#endif
+}
+
+static inline int bits_needed(uint64_t value)
+{
+    return value ? 64 - __builtin_clzll(value) : 0;
+}
+
+// differences inside block, first one is always 0 and the tail of the last block is padded with 0
+static void block_deltas(const int64_t *values, int length, int block, uint64_t *deltas)
+{
+    int start = block * PACKED_ARRAY_BLOCK;
+    int count = length - start < PACKED_ARRAY_BLOCK ? length - start : PACKED_ARRAY_BLOCK;
+    int k = 0;
+
+    deltas[0] = 0;
+    for (k = 1; k < count; k++) {
+        deltas[k] = (uint64_t) values[start + k] - (uint64_t) values[start + k - 1];
+    }
+    for (; k < PACKED_ARRAY_BLOCK; k++) {
+        deltas[k] = 0;
+    }
+}
+
+PackedArray *PackedArray_create(const int64_t *values, int length)
+{
+    PackedArray *array = NULL;
+    uint64_t deltas[PACKED_ARRAY_BLOCK];
+
+    check(values != NULL || length == 0, "Somehow got values that are NULL.");
+    check(length >= 0, "Length can't be negative.");
+
+    int i = 0, block = 0;
+    for (i = 1; i < length; i++) {
+        check(values[i - 1] <= values[i], "Values aren't sorted at %d.", i);
+    }
+
+    array = calloc(1, sizeof(PackedArray));
+    check_mem(array);
+
+    array->length = length;
+    array->block_count = (length + PACKED_ARRAY_BLOCK - 1) / PACKED_ARRAY_BLOCK;
+
+    int blocks = array->block_count > 0 ? array->block_count : 1;
+    array->firsts = malloc(sizeof(int64_t) * blocks);
+    check_mem(array->firsts);
+    array->offsets = malloc(sizeof(uint32_t) * blocks);
+    check_mem(array->offsets);
+    array->widths = malloc(sizeof(uint8_t) * blocks);
+    check_mem(array->widths);
+
+    // first pass sizes every block so packed words are allocated once
+    for (block = 0; block < array->block_count; block++) {
+        block_deltas(values, length, block, deltas);
+
+        uint64_t largest = 0;
+        for (i = 0; i < PACKED_ARRAY_BLOCK; i++) {
+            largest |= deltas[i];
+        }
+
+        check(array->word_count <= UINT32_MAX, "Packed array is too big.");
+        array->firsts[block] = values[block * PACKED_ARRAY_BLOCK];
+        array->widths[block] = (uint8_t) bits_needed(largest);
+        array->offsets[block] = (uint32_t) array->word_count;
+        array->word_count += (size_t) PACKED_ARRAY_LANES * array->widths[block];
+    }
+
+    array->words = malloc(sizeof(uint64_t) * (array->word_count > 0 ? array->word_count : 1));
+    check_mem(array->words);
+
+    // blocks of equal values have width 0 and no words at all
+    for (block = 0; block < array->block_count; block++) {
+        if (!array->widths[block]) continue;
+        block_deltas(values, length, block, deltas);
+        pack_block(deltas, array->widths[block], array->words + array->offsets[block]);
+    }
+
+    return array;
+
+error:
+    PackedArray_destroy(&array);
+    return NULL;
+}
+
+PackedArray *PackedArray_from_DArray(DArray *array, int element_kind)
+{
+    int64_t *values = NULL;
+    PackedArray *packed = NULL;
+
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(element_kind == PACKED_ARRAY_INLINE || element_kind == PACKED_ARRAY_BOXED, "Unknown element kind %d.", element_kind);
+
+    values = malloc(sizeof(int64_t) * (array->length > 0 ? array->length : 1));
+    check_mem(values);
+
+    int i = 0;
+    for (i = 0; i < array->length; i++) {
+        // inline contents are read as pointers and converted, not through an int64_t view of them
+        if (element_kind == PACKED_ARRAY_INLINE) {
+            values[i] = (intptr_t) array->contents[i];
+            continue;
+        }
+
+        check(array->contents[i] != NULL, "Element %d is NULL.", i);
+        values[i] = *(int64_t *) array->contents[i];
+    }
+
+    packed = PackedArray_create(values, array->length);
+    free(values);
+
+    return packed;
+
+error:
+    free(values);
+    return NULL;
+}
+
+int PackedArray_decode_block(PackedArray *array, int block, int64_t *out)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(out != NULL, "Somehow got out that is NULL.");
+    check(block >= 0 && block < array->block_count, "Block %d is out of bounds.", block);
+
+    int count = array->length - block * PACKED_ARRAY_BLOCK;
+    count = count < PACKED_ARRAY_BLOCK ? count : PACKED_ARRAY_BLOCK;
+
+    uint64_t *deltas = (uint64_t *) out;
+    int width = array->widths[block];
+    if (width) {
+        unpack_kernel(array->words + array->offsets[block], width, deltas);
+    } else {
+        memset(deltas, 0, sizeof(uint64_t) * PACKED_ARRAY_BLOCK);
+    }
+
+    // differences back to values, unsigned so wrapping between far apart values is well defined
+    uint64_t value = (uint64_t) array->firsts[block];
+    int k = 0;
+    for (k = 0; k < count; k++) {
+        value += deltas[k];
+        out[k] = (int64_t) value;
+    }
+
+    return count;
+
+error:
+    return CERB_ERR;
+}
+
+int PackedArray_get(PackedArray *array, int i, int64_t *out)
+{
+    int64_t values[PACKED_ARRAY_BLOCK];
+
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(out != NULL, "Somehow got out that is NULL.");
+    check(i >= 0 && i < array->length, "Index %d is out of bounds.", i);
+
+    int rc = PackedArray_decode_block(array, i / PACKED_ARRAY_BLOCK, values);
+    check(rc != CERB_ERR, "Couldn't decode block.");
+
+    *out = values[i % PACKED_ARRAY_BLOCK];
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int PackedArray_lower_bound(PackedArray *array, int64_t key)
+{
+    int64_t values[PACKED_ARRAY_BLOCK];
+
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    // first block starting at or after key, the answer is in the block before it or is its start
+    int low = 0, high = array->block_count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (array->firsts[middle] < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == 0) return 0;
+
+    int block = low - 1;
+    int count = PackedArray_decode_block(array, block, values);
+    check(count != CERB_ERR, "Couldn't decode block.");
+
+    int k = 0;
+    while (k < count && values[k] < key) k++;
+
+    return block * PACKED_ARRAY_BLOCK + k;
+
+error:
+    return CERB_ERR;
+}
+
+int PackedArray_find(PackedArray *array, int64_t key)
+{
+    int64_t value = 0;
+
+    int i = PackedArray_lower_bound(array, key);
+    check(i != CERB_ERR, "Couldn't search array.");
+
+    if (i == array->length) return -1;
+
+    int rc = PackedArray_get(array, i, &value);
+    check(rc != CERB_ERR, "Couldn't get value.");
+
+    return value == key ? i : -1;
+
+error:
+    return CERB_ERR;
+}
+
+size_t PackedArray_bytes(PackedArray *array)
+{
+    if (!array) return 0;
+
+    return sizeof(PackedArray) + (size_t) array->block_count * (sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint8_t))
+        + array->word_count * sizeof(uint64_t);
+}
+
+int PackedArray_destroy(PackedArray **array)
+{
+    check(array != NULL, "Somehow got reference to array that is NULL.");
+
+    if (*array) {
+        free((*array)->firsts);
+        free((*array)->offsets);
+        free((*array)->widths);
+        free((*array)->words);
+        free(*array);
+        *array = NULL;
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,54 @@
+#ifndef EAFA9567_B5C8_4FFB_A01F_AC6D7D9B9C8D
+#define EAFA9567_B5C8_4FFB_A01F_AC6D7D9B9C8D
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include "DArray.h"
+#include "dbg.h"
+
+// values are cut into blocks of PACKED_ARRAY_BLOCK, every block keeps its first value in the skip index
+// and the differences between neighbours bit packed with as many bits as the largest one needs
+// differences are spread over 4 interleaved lanes so a whole block unpacks 4 at a time ( AVX2 when the CPU has it )
+#define PACKED_ARRAY_BLOCK 256
+#define PACKED_ARRAY_LANES 4
+
+// how DArray elements hold their values for PackedArray_from_DArray
+#define PACKED_ARRAY_INLINE 0 // pushed as (void *) (intptr_t) value
+#define PACKED_ARRAY_BOXED 1 // pointers to int64_t
+
+// read only array of sorted 64 bit integers, ids which are close to each other take a few bits each
+typedef struct PackedArray {
+    int length;
+    int block_count;
+    int64_t *firsts; // skip index, first value of every block
+    uint32_t *offsets; // word where every block's packed differences start
+    uint8_t *widths; // bits per difference in every block
+    uint64_t *words;
+    size_t word_count;
+} PackedArray;
+
+// pack length values sorted ascending ( duplicates are fine )
+PackedArray *PackedArray_create(const int64_t *values, int length);
+// pack a sorted DArray, elements are read as described by PACKED_ARRAY_INLINE or PACKED_ARRAY_BOXED
+PackedArray *PackedArray_from_DArray(DArray *array, int element_kind);
+
+// store value at position i in out
+int PackedArray_get(PackedArray *array, int i, int64_t *out);
+// unpack every value of block into out ( should fit PACKED_ARRAY_BLOCK values ) and return how many there are
+int PackedArray_decode_block(PackedArray *array, int block, int64_t *out);
+// position of the first value not less than key, length if there's none
+int PackedArray_lower_bound(PackedArray *array, int64_t key);
+// position of some value equal to key or -1 if there's none
+int PackedArray_find(PackedArray *array, int64_t key);
+
+// bytes taken by the array including its index
+size_t PackedArray_bytes(PackedArray *array);
+// free the array, pass a reference to make it NULL after freeing
+int PackedArray_destroy(PackedArray **array);
+
+#define PackedArray_length(A) ((A)->length)
+
+#endif /* EAFA9567_B5C8_4FFB_A01F_AC6D7D9B9C8D */
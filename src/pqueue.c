@@ -0,0 +1,267 @@
+#include "pqueue.h"
+
+#define NODE(Q, I) ((PQueueNode *) (Q)->heap->contents[(I)])
+
+static inline void place(PQueue *queue, PQueueNode *node, int i)
+{
+    queue->heap->contents[i] = node;
+    node->position = i;
+}
+
+// move node at i up while it's smaller than its parent, parents slide down into the hole
+static void sift_up(PQueue *queue, int i)
+{
+    PQueueNode *node = NODE(queue, i);
+
+    while (i > 0) {
+        int parent = (i - 1) / queue->arity;
+        if (queue->cmp_func(node->data, NODE(queue, parent)->data) >= 0) break;
+        place(queue, NODE(queue, parent), i);
+        i = parent;
+    }
+    place(queue, node, i);
+}
+
+// move node at i down while one of its children is smaller, the smallest child slides up into the hole
+static void sift_down(PQueue *queue, int i)
+{
+    PQueueNode *node = NODE(queue, i);
+    int length = queue->heap->length, arity = queue->arity;
+
+    for (;;) {
+        int first = arity * i + 1;
+        if (first >= length) break;
+
+        int last = first + arity < length ? first + arity : length;
+        int smallest = first, child = 0;
+        for (child = first + 1; child < last; child++) {
+            if (queue->cmp_func(NODE(queue, child)->data, NODE(queue, smallest)->data) < 0) smallest = child;
+        }
+
+        if (queue->cmp_func(NODE(queue, smallest)->data, node->data) >= 0) break;
+        place(queue, NODE(queue, smallest), i);
+        i = smallest;
+    }
+    place(queue, node, i);
+}
+
+// bottom up build, every parent from the last one to the root sinks into place ( O(n) in total )
+static void build(PQueue *queue)
+{
+    // ( length - 2 ) / arity rounds to 0 for 0 too, an empty heap would sift a node that isn't there
+    if (queue->heap->length < 2) return;
+
+    int i = 0;
+    for (i = (queue->heap->length - 2) / queue->arity; i >= 0; i--) {
+        sift_down(queue, i);
+    }
+}
+
+static PQueueNode *take_node(PQueue *queue, void *data)
+{
+    PQueueNode *node = queue->spare->length ? DArray_pop(queue->spare) : malloc(sizeof(PQueueNode));
+    check_mem(node);
+
+    node->data = data;
+
+    return node;
+
+error:
+    return NULL;
+}
+
+PQueue *PQueue_create(int arity, cmp_template cmp_func)
+{
+    PQueue *queue = NULL;
+
+    check(arity >= 2, "Arity has to be at least 2.");
+    check(cmp_func != NULL, "Somehow got cmp_func that is NULL.");
+
+    queue = calloc(1, sizeof(PQueue));
+    check_mem(queue);
+
+    queue->arity = arity;
+    queue->cmp_func = cmp_func;
+    queue->heap = DArray_create(sizeof(void *), DEFAULT_EXPAND_RATE, cmp_func);
+    check(queue->heap != NULL, "Couldn't create heap.");
+    queue->spare = DArray_create(sizeof(void *), DEFAULT_EXPAND_RATE, NULL);
+    check(queue->spare != NULL, "Couldn't create spare nodes array.");
+
+    return queue;
+
+error:
+    PQueue_destroy(&queue);
+    return NULL;
+}
+
+PQueue *PQueue_heapify(DArray *array, int arity)
+{
+    PQueue *queue = NULL;
+
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    queue = PQueue_create(arity, array->cmp_func);
+    check(queue != NULL, "Couldn't create queue.");
+
+    int rc = PQueue_push_many(queue, array->contents, array->length, NULL);
+    check(rc != CERB_ERR, "Couldn't push array's elements.");
+
+    return queue;
+
+error:
+    PQueue_destroy(&queue);
+    return NULL;
+}
+
+PQueueNode *PQueue_push(PQueue *queue, void *data)
+{
+    PQueueNode *node = NULL;
+
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    node = take_node(queue, data);
+    check(node != NULL, "Couldn't make node.");
+
+    int rc = DArray_push(queue->heap, node);
+    check(rc != CERB_ERR, "Couldn't push node to heap.");
+
+    sift_up(queue, queue->heap->length - 1);
+
+    return node;
+
+error:
+    free(node);
+    return NULL;
+}
+
+int PQueue_push_many(PQueue *queue, void **data, int count, PQueueNode **handles)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(data != NULL || count == 0, "Somehow got data that is NULL.");
+    check(count >= 0, "Count can't be negative.");
+
+    int i = 0, old_length = queue->heap->length;
+    for (i = 0; i < count; i++) {
+        PQueueNode *node = take_node(queue, data[i]);
+        check(node != NULL, "Couldn't make node.");
+
+        int rc = DArray_push(queue->heap, node);
+        if (rc == CERB_ERR) free(node);
+        check(rc != CERB_ERR, "Couldn't push node to heap.");
+
+        node->position = queue->heap->length - 1;
+        if (handles) handles[i] = node;
+    }
+
+    // sifting up costs about log n per element, rebuilding the whole heap costs about 2 per element
+    if (count > old_length) {
+        build(queue);
+    } else {
+        for (i = old_length; i < queue->heap->length; i++) {
+            sift_up(queue, i);
+        }
+    }
+
+    return CERB_OK;
+
+error:
+    // whatever got appended still has to form a heap
+    if (queue) build(queue);
+    return CERB_ERR;
+}
+
+void *PQueue_pop_min(PQueue *queue)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    if (queue->heap->length == 0) return NULL;
+
+    PQueueNode *top = NODE(queue, 0);
+    PQueueNode *last = DArray_pop(queue->heap);
+    check(last != NULL, "Couldn't pop from heap.");
+
+    if (queue->heap->length > 0) {
+        place(queue, last, 0);
+        sift_down(queue, 0);
+    }
+
+    void *data = top->data;
+    if (DArray_push(queue->spare, top) == CERB_ERR) free(top);
+
+    return data;
+
+error:
+    return NULL;
+}
+
+void *PQueue_peek(PQueue *queue)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    return queue->heap->length ? NODE(queue, 0)->data : NULL;
+
+error:
+    return NULL;
+}
+
+int PQueue_decrease_key(PQueue *queue, PQueueNode *handle)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(handle != NULL, "Somehow got handle that is NULL.");
+    check(handle->position >= 0 && handle->position < queue->heap->length && NODE(queue, handle->position) == handle,
+            "Handle isn't in this queue.");
+
+    sift_up(queue, handle->position);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+static void free_nodes(DArray *nodes)
+{
+    int i = 0;
+    for (i = 0; i < nodes->length; i++) {
+        free(nodes->contents[i]);
+    }
+}
+
+int PQueue_destroy(PQueue **queue)
+{
+    check(queue != NULL, "Somehow got reference to queue that is NULL.");
+
+    if (*queue) {
+        if ((*queue)->heap) {
+            free_nodes((*queue)->heap);
+            DArray_destroy(&(*queue)->heap);
+        }
+        if ((*queue)->spare) {
+            free_nodes((*queue)->spare);
+            DArray_destroy(&(*queue)->spare);
+        }
+        free(*queue);
+        *queue = NULL;
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int PQueue_free_complex_data(PQueue **queue, free_func handler_func)
+{
+    check(queue != NULL && *queue != NULL, "Somehow got queue that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    int i = 0;
+    for (i = 0; i < (*queue)->heap->length; i++) {
+        handler_func(NODE(*queue, i)->data);
+    }
+
+    return PQueue_destroy(queue);
+
+error:
+    return CERB_ERR;
+}
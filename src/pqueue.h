@@ -0,0 +1,50 @@
+#ifndef FD1F4266_115F_4619_889A_1C7352C9D8DE
+#define FD1F4266_115F_4619_889A_1C7352C9D8DE
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include "DArray.h"
+
+// d-ary min heap ( smallest by cmp_func on top ) kept in a DArray
+// 4-ary heaps are shallower than binary ones and the children of a node share a cache line
+#define PQUEUE_BINARY 2
+#define PQUEUE_QUAD 4
+
+// handle of an element in the queue, valid until the element is popped
+typedef struct PQueueNode {
+    void *data;
+    int position; // where the node is in the heap right now
+} PQueueNode;
+
+typedef struct PQueue {
+    int arity;
+    cmp_template cmp_func;
+    DArray *heap; // contents are PQueueNode *
+    DArray *spare; // nodes of popped elements which get reused by next pushes
+} PQueue;
+
+// create an empty queue where every node has arity children ( at least 2 )
+PQueue *PQueue_create(int arity, cmp_template cmp_func);
+// create a queue out of array's elements in O(n) using array's cmp_func ( array itself isn't changed )
+PQueue *PQueue_heapify(DArray *array, int arity);
+// push data and return its handle
+PQueueNode *PQueue_push(PQueue *queue, void *data);
+// push count elements of data, if handles isn't NULL their handles are stored there
+// big batches are appended and the heap gets rebuilt in O(n) instead of pushing one by one
+int PQueue_push_many(PQueue *queue, void **data, int count, PQueueNode **handles);
+// remove and return the smallest element, NULL if queue is empty
+void *PQueue_pop_min(PQueue *queue);
+// smallest element without removing it, NULL if queue is empty
+void *PQueue_peek(PQueue *queue);
+// call after making handle's data compare smaller ( e.g. lowering its priority field ) to move it up
+int PQueue_decrease_key(PQueue *queue, PQueueNode *handle);
+
+// free the queue ( THIS DOES NOT FREE THE DATA IN IT ), pass a reference to make it NULL after freeing
+int PQueue_destroy(PQueue **queue);
+// apply handler_func to every element and then PQueue_destroy
+int PQueue_free_complex_data(PQueue **queue, free_func handler_func);
+
+#define PQueue_length(Q) ((Q)->heap->length)
+
+#endif /* FD1F4266_115F_4619_889A_1C7352C9D8DE */
@@ -0,0 +1,172 @@
+#include "queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MASK(Q) ((Q)->capacity - 1)
+
+Queue *Queue_create(void)
+{
+    Queue *queue = calloc(1, sizeof(Queue));
+    check_mem(queue);
+
+    queue->slots = malloc(sizeof(QueueSlot) * QUEUE_INITIAL_CAPACITY);
+    check_mem(queue->slots);
+    queue->capacity = QUEUE_INITIAL_CAPACITY;
+
+    return queue;
+
+error:
+    if (queue) free(queue);
+    return NULL;
+}
+
+int Queue_reserve(Queue *queue, uint32_t capacity)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(capacity <= (UINT32_C(1) << 31), "Queue can't hold more than 2^31 elements.");
+
+    if (capacity <= queue->capacity) return CERB_OK;
+
+    uint32_t new_capacity = queue->capacity;
+    while (new_capacity < capacity) new_capacity <<= 1;
+
+    QueueSlot *slots = malloc(sizeof(QueueSlot) * new_capacity);
+    check_mem(slots);
+
+    // elements may wrap around the end of the ring, they get unwrapped to start at 0
+    uint32_t to_end = queue->capacity - queue->head;
+    uint32_t first_part = queue->count < to_end ? queue->count : to_end;
+    memcpy(slots, queue->slots + queue->head, sizeof(QueueSlot) * first_part);
+    memcpy(slots + first_part, queue->slots, sizeof(QueueSlot) * (queue->count - first_part));
+
+    free(queue->slots);
+    queue->slots = slots;
+    queue->capacity = new_capacity;
+    queue->head = 0;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Queue_unshift(Queue *queue, void *data)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    if (queue->count == queue->capacity) {
+        int rc = Queue_reserve(queue, queue->count + 1);
+        check(rc != CERB_ERR, "Couldn't grow queue.");
+    }
+
+    queue->slots[(queue->head + queue->count) & MASK(queue)].data = data;
+    queue->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *Queue_pop(Queue *queue)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    if (!queue->count) return NULL;
+
+    void *data = queue->slots[queue->head].data;
+    queue->head = (queue->head + 1) & MASK(queue);
+    queue->count--;
+
+    return data;
+
+error:
+    return NULL;
+}
+
+void *Queue_peek(Queue *queue)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    return queue->count ? queue->slots[queue->head].data : NULL;
+
+error:
+    return NULL;
+}
+
+int Queue_unshift_many(Queue *queue, void **data, uint32_t count)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(data != NULL || count == 0, "Somehow got data that is NULL.");
+    check(count <= UINT32_MAX - queue->count, "Queue would be longer than UINT32_MAX.");
+
+    int rc = Queue_reserve(queue, queue->count + count);
+    check(rc != CERB_ERR, "Couldn't grow queue.");
+
+    // at most two copies, up to the end of the ring and then from its start
+    uint32_t tail = (queue->head + queue->count) & MASK(queue);
+    uint32_t to_end = queue->capacity - tail;
+    uint32_t first_part = count < to_end ? count : to_end;
+    memcpy(queue->slots + tail, data, sizeof(void *) * first_part);
+    memcpy(queue->slots, data + first_part, sizeof(void *) * (count - first_part));
+    queue->count += count;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Queue_pop_many(Queue *queue, void **out, uint32_t count)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(out != NULL || count == 0, "Somehow got out that is NULL.");
+    check(count <= INT32_MAX, "Can't pop more than INT32_MAX elements at once.");
+
+    uint32_t popped = count < queue->count ? count : queue->count;
+    uint32_t to_end = queue->capacity - queue->head;
+    uint32_t first_part = popped < to_end ? popped : to_end;
+    memcpy(out, queue->slots + queue->head, sizeof(void *) * first_part);
+    memcpy(out + first_part, queue->slots, sizeof(void *) * (popped - first_part));
+
+    queue->head = (queue->head + popped) & MASK(queue);
+    queue->count -= popped;
+
+    return (int) popped;
+
+error:
+    return CERB_ERR;
+}
+
+int Queue_destroy(Queue **queue)
+{
+    check(queue != NULL, "Somehow got an address of the queue that is NULL.");
+    check(*queue != NULL, "Somehow got queue that is NULL.");
+
+    free((*queue)->slots);
+    free(*queue);
+    *queue = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Queue_free_complex_data(Queue **queue, free_func handler_func)
+{
+    check(queue != NULL, "Somehow got an address of the queue that is NULL.");
+    check(*queue != NULL, "Somehow got queue that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    uint32_t i = 0;
+    for (i = 0; i < (*queue)->count; i++) {
+        handler_func((*queue)->slots[((*queue)->head + i) & MASK(*queue)].data);
+    }
+
+    return Queue_destroy(queue);
+
+error:
+    return CERB_ERR;
+}
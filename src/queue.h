@@ -1,33 +1,82 @@
 #ifndef D9763356_738A_4CC3_81EE_E99D6E5B226A
 #define D9763356_738A_4CC3_81EE_E99D6E5B226A
 
-#include "doubly_linked.h"
+#define CERB_OK 0
+#define CERB_ERR -1
 
-#define Queue DLinked
+#include <stdint.h>
+#include "dbg.h"
 
-// get how many elements queue has
-#define Queue_get_count(queue) DLinked_get_count(queue)
+typedef void (*free_func) (void *data);
+
+// capacity is always a power of two, it starts here and doubles whenever queue is full
+#define QUEUE_INITIAL_CAPACITY 16
+
+// one element, iteration macros give you pointers to these so cur->data works like with list nodes
+typedef struct QueueSlot {
+    void *data;
+} QueueSlot;
+
+// queue kept in a ring buffer, unshift and pop only move head and count ( nothing is allocated per element )
+typedef struct Queue {
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t head; // slot of the oldest element, the one pop returns next
+    QueueSlot *slots;
+} Queue;
 
-// create a queue 
-#define Queue_create() DLinked_create(NULL)
+// create a queue
+Queue *Queue_create(void);
 // unshift void *data in queue
-#define Queue_unshift(queue, data) DLinked_unshift(queue, data)
-// pop and return from queue
-#define Queue_pop(queue) DLinked_pop(queue)
+int Queue_unshift(Queue *queue, void *data);
+// pop and return from queue ( oldest element ), NULL if queue is empty
+void *Queue_pop(Queue *queue);
+// return element pop would return without popping it, NULL if queue is empty
+void *Queue_peek(Queue *queue);
+// unshift count elements of data, data[0] gets popped first
+int Queue_unshift_many(Queue *queue, void **data, uint32_t count);
+// pop up to count elements into out ( oldest first ) and return how many got popped
+int Queue_pop_many(Queue *queue, void **out, uint32_t count);
+// make room for at least capacity elements
+int Queue_reserve(Queue *queue, uint32_t capacity);
+
+// free queue but not data it contains, always pass a reference to make it NULL after freeing
+int Queue_destroy(Queue **queue);
 // if data structure, which nodes contain is complex (for example struct containing pointers)
 // use this function which iterates through list and applies your handler_func to all of it's *data fields
-#define Queue_free_complex_data(queue, handler_func) DLinked_free_complex_data(queue, handler_func)
+int Queue_free_complex_data(Queue **queue, free_func handler_func);
+
+// get how many elements queue has
+#define Queue_get_count(queue) (queue)->count
 
-// iterate through queue
+// iterate through queue from the newest element to the oldest one
 // queue is Queue *, cur is current node's name you specify
-#define Queue_iter(queue, cur) DLinked_iter(queue, first, next, cur)
+#define Queue_iter(queue, cur) QueueSlot *cur = NULL; uint32_t _slot = 0;\
+        for (_slot = (queue)->count; _slot > 0 &&\
+                (cur = &(queue)->slots[((queue)->head + _slot - 1) & ((queue)->capacity - 1)]); _slot--)
 // print queue contents
 // queue is Queue *, _data is a function returning printable data like ( int, char *, char, float ) ...
 // format is "%s" "%d" ... according to what data returns
-#define Queue_print(queue, _data, format) DLinked_print(queue, first, next, _data, format)
+#define Queue_print(queue, _data, format) if (queue) {\
+            printf("\n[ ");\
+            Queue_iter (queue, cur) { printf((format " -> "), _data(cur->data)); }\
+            printf("NULL ]\n");\
+        } else {\
+            log_err("Somehow got queue that is NULL.");\
+        }
 // queue is Queue *
 // cmp_fucn is a function pointer which compares search data and every node's data
 // to find is the data you are looking for and found node is the variable name you want found data to be in
-#define Queue_search(queue, cmp_func, to_find, found_node) DLinked_search(queue, first, next, cmp_func, to_find, found_node)
+#define Queue_search(queue, cmp_func, to_find, found_node) QueueSlot *found_node = NULL;\
+        if (queue) {\
+            Queue_iter (queue, cur) {\
+                if (cmp_func(to_find, cur->data) == 0) {\
+                    found_node = cur;\
+                    break;\
+                }\
+            }\
+        } else {\
+            log_err("Somehow got queue that is NULL.");\
+        }
 
-#endif /* D9763356_738A_4CC3_81EE_E99D6E5B226A */
\ No newline at end of file
+#endif /* D9763356_738A_4CC3_81EE_E99D6E5B226A */
@@ -0,0 +1,333 @@
+#include "scan.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+typedef int64_t (*find_u64_func) (const uint64_t *values, size_t length, uint64_t value);
+typedef size_t (*count_u64_func) (const uint64_t *values, size_t length, uint64_t value);
+typedef int64_t (*minmax_i64_func) (const int64_t *values, size_t length);
+typedef size_t (*intersect_i64_func) (const int64_t *a, size_t a_length, const int64_t *b, size_t b_length, int64_t *out);
+
+// values often are some other 8 byte type ( DArray passes its void * contents ), so scalar code
+// reads and writes them through memcpy, vector loads and stores may alias anything already
+static inline uint64_t load_u64(const uint64_t *value)
+{
+    uint64_t rc;
+    memcpy(&rc, value, sizeof(rc));
+    return rc;
+}
+
+static inline int64_t load_i64(const int64_t *value)
+{
+    int64_t rc;
+    memcpy(&rc, value, sizeof(rc));
+    return rc;
+}
+
+static inline void store_i64(int64_t *to, int64_t value)
+{
+    memcpy(to, &value, sizeof(value));
+}
+
+/* scalar kernels ( always available, also handle the tails of vector kernels ) */
+
+static int64_t find_u64_scalar(const uint64_t *values, size_t length, uint64_t value)
+{
+    size_t i = 0;
+    for (i = 0; i < length; i++) {
+        if (load_u64(values + i) == value) {
+            return (int64_t) i;
+        }
+    }
+
+    return -1;
+}
+
+static size_t count_u64_scalar(const uint64_t *values, size_t length, uint64_t value)
+{
+    size_t i = 0, count = 0;
+    for (i = 0; i < length; i++) {
+        count += load_u64(values + i) == value;
+    }
+
+    return count;
+}
+
+static int64_t min_i64_scalar(const int64_t *values, size_t length)
+{
+    int64_t min = load_i64(values);
+    size_t i = 0;
+    for (i = 1; i < length; i++) {
+        int64_t cur = load_i64(values + i);
+        min = cur < min ? cur : min;
+    }
+
+    return min;
+}
+
+static int64_t max_i64_scalar(const int64_t *values, size_t length)
+{
+    int64_t max = load_i64(values);
+    size_t i = 0;
+    for (i = 1; i < length; i++) {
+        int64_t cur = load_i64(values + i);
+        max = cur > max ? cur : max;
+    }
+
+    return max;
+}
+
+// merge without branching on which side moves, mispredictions are what makes plain merging slow
+static size_t intersect_i64_scalar(const int64_t *a, size_t a_length, const int64_t *b, size_t b_length, int64_t *out)
+{
+    size_t i = 0, j = 0, count = 0;
+
+    while (i < a_length && j < b_length) {
+        int64_t x = load_i64(a + i), y = load_i64(b + j);
+        store_i64(out + count, x);
+        count += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+
+    return count;
+}
+
+#ifdef SCAN_X86
+
+/* SSE2 kernels ( SSE2 has no 64 bit compares, so equality is built from two 32 bit halves ) */
+
+__attribute__((target("sse2")))
+static inline __m128i cmpeq_u64_sse2(__m128i a, __m128i b)
+{
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+__attribute__((target("sse2")))
+static int64_t find_u64_sse2(const uint64_t *values, size_t length, uint64_t value)
+{
+    __m128i needle = _mm_set1_epi64x((long long) value);
+    size_t i = 0;
+
+    for (; i + 4 <= length; i += 4) {
+        __m128i eq0 = cmpeq_u64_sse2(_mm_loadu_si128((const __m128i *) (values + i)), needle);
+        __m128i eq1 = cmpeq_u64_sse2(_mm_loadu_si128((const __m128i *) (values + i + 2)), needle);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(eq0)) | (_mm_movemask_pd(_mm_castsi128_pd(eq1)) << 2);
+        if (mask) {
+            return (int64_t) (i + __builtin_ctz(mask));
+        }
+    }
+
+    int64_t rc = find_u64_scalar(values + i, length - i, value);
+    return rc < 0 ? rc : rc + (int64_t) i;
+}
+
+__attribute__((target("sse2")))
+static size_t count_u64_sse2(const uint64_t *values, size_t length, uint64_t value)
+{
+    __m128i needle = _mm_set1_epi64x((long long) value);
+    __m128i counts = _mm_setzero_si128();
+    size_t i = 0;
+
+    // every match is -1 in its lane, so subtracting the masks counts them
+    for (; i + 2 <= length; i += 2) {
+        counts = _mm_sub_epi64(counts, cmpeq_u64_sse2(_mm_loadu_si128((const __m128i *) (values + i)), needle));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, counts);
+
+    return (size_t) (lanes[0] + lanes[1]) + count_u64_scalar(values + i, length - i, value);
+}
+
+/* AVX2 kernels */
+
+__attribute__((target("avx2")))
+static int64_t find_u64_avx2(const uint64_t *values, size_t length, uint64_t value)
+{
+    __m256i needle = _mm256_set1_epi64x((long long) value);
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        __m256i eq0 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) (values + i)), needle);
+        __m256i eq1 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) (values + i + 4)), needle);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq0)) | (_mm256_movemask_pd(_mm256_castsi256_pd(eq1)) << 4);
+        if (mask) {
+            return (int64_t) (i + __builtin_ctz(mask));
+        }
+    }
+
+    int64_t rc = find_u64_scalar(values + i, length - i, value);
+    return rc < 0 ? rc : rc + (int64_t) i;
+}
+
+__attribute__((target("avx2")))
+static size_t count_u64_avx2(const uint64_t *values, size_t length, uint64_t value)
+{
+    __m256i needle = _mm256_set1_epi64x((long long) value);
+    __m256i counts = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 4 <= length; i += 4) {
+        counts = _mm256_sub_epi64(counts, _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) (values + i)), needle));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, counts);
+
+    return (size_t) (lanes[0] + lanes[1] + lanes[2] + lanes[3]) + count_u64_scalar(values + i, length - i, value);
+}
+
+__attribute__((target("avx2")))
+static int64_t min_i64_avx2(const int64_t *values, size_t length)
+{
+    if (length < 4) return min_i64_scalar(values, length);
+
+    __m256i min = _mm256_loadu_si256((const __m256i *) values);
+    size_t i = 4;
+
+    for (; i + 4 <= length; i += 4) {
+        __m256i cur = _mm256_loadu_si256((const __m256i *) (values + i));
+        min = _mm256_blendv_epi8(min, cur, _mm256_cmpgt_epi64(min, cur));
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, min);
+
+    int64_t rc = min_i64_scalar(lanes, 4);
+    if (i < length) {
+        int64_t tail = min_i64_scalar(values + i, length - i);
+        rc = tail < rc ? tail : rc;
+    }
+
+    return rc;
+}
+
+__attribute__((target("avx2")))
+static int64_t max_i64_avx2(const int64_t *values, size_t length)
+{
+    if (length < 4) return max_i64_scalar(values, length);
+
+    __m256i max = _mm256_loadu_si256((const __m256i *) values);
+    size_t i = 4;
+
+    for (; i + 4 <= length; i += 4) {
+        __m256i cur = _mm256_loadu_si256((const __m256i *) (values + i));
+        max = _mm256_blendv_epi8(max, cur, _mm256_cmpgt_epi64(cur, max));
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, max);
+
+    int64_t rc = max_i64_scalar(lanes, 4);
+    if (i < length) {
+        int64_t tail = max_i64_scalar(values + i, length - i);
+        rc = tail > rc ? tail : rc;
+    }
+
+    return rc;
+}
+
+// compare blocks of 4 against each other in every rotation, then move whichever block ends lower
+__attribute__((target("avx2")))
+static size_t intersect_i64_avx2(const int64_t *a, size_t a_length, const int64_t *b, size_t b_length, int64_t *out)
+{
+    size_t i = 0, j = 0, count = 0;
+
+    while (i + 4 <= a_length && j + 4 <= b_length) {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *) (b + j));
+
+        __m256i eq = _mm256_cmpeq_epi64(va, vb);
+        eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        while (mask) {
+            store_i64(out + count++, load_i64(a + i + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+
+        int64_t a_last = load_i64(a + i + 3), b_last = load_i64(b + j + 3);
+        i += a_last <= b_last ? 4 : 0;
+        j += b_last <= a_last ? 4 : 0;
+    }
+
+    return count + intersect_i64_scalar(a + i, a_length - i, b + j, b_length - j, out + count);
+}
+
+#endif /* SCAN_X86 */
+
+/* runtime dispatch */
+
+static find_u64_func find_u64_kernel = find_u64_scalar;
+static count_u64_func count_u64_kernel = count_u64_scalar;
+static minmax_i64_func min_i64_kernel = min_i64_scalar;
+static minmax_i64_func max_i64_kernel = max_i64_scalar;
+static intersect_i64_func intersect_i64_kernel = intersect_i64_scalar;
+static const char *kernel_name = "scalar";
+
+__attribute__((constructor))
+static void Scan_select_kernels(void)
+{
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        find_u64_kernel = find_u64_avx2;
+        count_u64_kernel = count_u64_avx2;
+        min_i64_kernel = min_i64_avx2;
+        max_i64_kernel = max_i64_avx2;
+        intersect_i64_kernel = intersect_i64_avx2;
+        kernel_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        // min, max and intersect stay scalar, SSE2 can't compare 64 bit integers
+        find_u64_kernel = find_u64_sse2;
+        count_u64_kernel = count_u64_sse2;
+        kernel_name = "sse2";
+    }
+#endif
+}
+
+int64_t Scan_find_u64(const uint64_t *values, size_t length, uint64_t value)
+{
+    return find_u64_kernel(values, length, value);
+}
+
+size_t Scan_count_u64(const uint64_t *values, size_t length, uint64_t value)
+{
+    return count_u64_kernel(values, length, value);
+}
+
+int64_t Scan_min_i64(const int64_t *values, size_t length)
+{
+    return min_i64_kernel(values, length);
+}
+
+int64_t Scan_max_i64(const int64_t *values, size_t length)
+{
+    return max_i64_kernel(values, length);
+}
+
+size_t Scan_intersect_i64(const int64_t *a, size_t a_length, const int64_t *b, size_t b_length, int64_t *out)
+{
+    return intersect_i64_kernel(a, a_length, b, b_length, out);
+}
+
+// libc memchr is already vectorised and dispatched per CPU, so we just wrap it
+int64_t Scan_find_u8(const uint8_t *bytes, size_t length, uint8_t byte)
+{
+    const uint8_t *found = length ? memchr(bytes, byte, length) : NULL;
+
+    return found ? (int64_t) (found - bytes) : -1;
+}
+
+const char *Scan_kernel_name(void)
+{
+    return kernel_name;
+}
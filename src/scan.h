@@ -0,0 +1,29 @@
+#ifndef A3312AF0_F27F_4560_876F_D4D1829A944E
+#define A3312AF0_F27F_4560_876F_D4D1829A944E
+
+#include <stddef.h>
+#include <stdint.h>
+
+// linear scan kernels used by DArray ( and free to use on any plain array )
+// on x86 the fastest of AVX2, SSE2 and scalar versions is picked once at program start
+// elements are loaded with memcpy, so values can point at any 8 byte elements ( like void * on 64 bit )
+
+// position of the first value equal to value or -1 if there's none
+int64_t Scan_find_u64(const uint64_t *values, size_t length, uint64_t value);
+// how many values are equal to value
+size_t Scan_count_u64(const uint64_t *values, size_t length, uint64_t value);
+// smallest value ( length should be > 0 )
+int64_t Scan_min_i64(const int64_t *values, size_t length);
+// largest value ( length should be > 0 )
+int64_t Scan_max_i64(const int64_t *values, size_t length);
+// position of the first byte equal to byte or -1 if there's none ( same as memchr )
+int64_t Scan_find_u8(const uint8_t *bytes, size_t length, uint8_t byte);
+
+// write values found in both strictly increasing arrays a and b to out ( it should fit the smaller one )
+// and return how many there are
+size_t Scan_intersect_i64(const int64_t *a, size_t a_length, const int64_t *b, size_t b_length, int64_t *out);
+
+// name of the kernel set which got selected ( "avx2", "sse2" or "scalar" )
+const char *Scan_kernel_name(void);
+
+#endif /* A3312AF0_F27F_4560_876F_D4D1829A944E */
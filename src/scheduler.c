@@ -0,0 +1,278 @@
+#include "scheduler.h"
+#include <stdlib.h>
+#include <sched.h>
+
+typedef struct Task {
+    Task_func func;
+    void *arg;
+    TaskGroup *group;
+} Task;
+
+static _Thread_local SchedulerWorker *current_worker = NULL;
+static _Thread_local uint64_t steal_seed = 0;
+
+// xorshift, victims only need to be spread out, not unpredictable
+static inline uint64_t next_random(void)
+{
+    if (!steal_seed) steal_seed = (uint64_t) (uintptr_t) &steal_seed | 1;
+
+    steal_seed ^= steal_seed << 13;
+    steal_seed ^= steal_seed >> 7;
+    steal_seed ^= steal_seed << 17;
+
+    return steal_seed;
+}
+
+static inline SchedulerWorker *self_in(Scheduler *scheduler)
+{
+    return current_worker && current_worker->scheduler == scheduler ? current_worker : NULL;
+}
+
+// own deque first ( newest task, its data is still in cache ), then outside tasks, then other workers' oldest tasks
+static Task *find_task(Scheduler *scheduler, SchedulerWorker *self)
+{
+    Task *task = NULL;
+
+    if (self && (task = WSDeque_pop(self->deque))) return task;
+    if ((task = MPMCQueue_try_pop(scheduler->injected))) return task;
+
+    int count = scheduler->worker_count;
+    if (count == 0) return NULL;
+
+    int start = (int) (next_random() % (uint64_t) count), k = 0;
+    for (k = 0; k < count; k++) {
+        SchedulerWorker *victim = &scheduler->workers[(start + k) % count];
+        if (victim == self) continue;
+        if ((task = WSDeque_steal(victim->deque))) return task;
+    }
+
+    return NULL;
+}
+
+static inline void run_task(Task *task)
+{
+    TaskGroup *group = task->group;
+
+    task->func(task->arg);
+    free(task);
+    // release makes everything the task wrote visible to whoever sees the group done
+    atomic_fetch_sub_explicit(&group->pending, 1, memory_order_release);
+}
+
+// spawners look at sleepers after their task is visible, a worker registers itself before its last look,
+// so with the fences in between either the spawner sees the sleeper or the sleeper sees the task
+static void wake_worker(Scheduler *scheduler)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(&scheduler->sleepers, memory_order_relaxed)) {
+        pthread_mutex_lock(&scheduler->park_lock);
+        scheduler->wakeups++;
+        pthread_cond_signal(&scheduler->park);
+        pthread_mutex_unlock(&scheduler->park_lock);
+    }
+}
+
+static void *worker_loop(void *arg)
+{
+    SchedulerWorker *self = arg;
+    Scheduler *scheduler = self->scheduler;
+    int idle = 0;
+
+    current_worker = self;
+
+    while (!atomic_load_explicit(&scheduler->shutdown, memory_order_acquire)) {
+        Task *task = find_task(scheduler, self);
+        if (task) {
+            run_task(task);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SCHEDULER_SPINS) {
+            sched_yield();
+            continue;
+        }
+
+        pthread_mutex_lock(&scheduler->park_lock);
+        uint64_t seen = scheduler->wakeups;
+        pthread_mutex_unlock(&scheduler->park_lock);
+
+        atomic_fetch_add_explicit(&scheduler->sleepers, 1, memory_order_seq_cst);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        task = find_task(scheduler, self);
+        if (!task) {
+            pthread_mutex_lock(&scheduler->park_lock);
+            while (scheduler->wakeups == seen && !atomic_load_explicit(&scheduler->shutdown, memory_order_acquire)) {
+                pthread_cond_wait(&scheduler->park, &scheduler->park_lock);
+            }
+            pthread_mutex_unlock(&scheduler->park_lock);
+        }
+        atomic_fetch_sub_explicit(&scheduler->sleepers, 1, memory_order_relaxed);
+
+        if (task) run_task(task);
+        idle = 0;
+    }
+
+    current_worker = NULL;
+
+    return NULL;
+}
+
+/* create and destroy */
+
+Scheduler *Scheduler_create(int workers)
+{
+    Scheduler *scheduler = NULL;
+
+    check(workers >= 0, "Worker count can't be negative.");
+
+    scheduler = calloc(1, sizeof(Scheduler));
+    check_mem(scheduler);
+
+    pthread_mutex_init(&scheduler->park_lock, NULL);
+    pthread_cond_init(&scheduler->park, NULL);
+    atomic_init(&scheduler->shutdown, 0);
+    atomic_init(&scheduler->sleepers, 0);
+
+    scheduler->injected = MPMCQueue_create(SCHEDULER_INJECT_CAPACITY);
+    check(scheduler->injected != NULL, "Couldn't create queue for outside tasks.");
+
+    scheduler->workers = calloc(workers > 0 ? workers : 1, sizeof(SchedulerWorker));
+    check_mem(scheduler->workers);
+
+    int i = 0;
+    for (i = 0; i < workers; i++) {
+        scheduler->workers[i].scheduler = scheduler;
+        scheduler->workers[i].index = i;
+        scheduler->workers[i].deque = WSDeque_create();
+        check(scheduler->workers[i].deque != NULL, "Couldn't create deque for worker %d.", i);
+    }
+    // every deque exists before any worker starts stealing from them
+    // deques of workers which fail to start stay empty, only their owner would push to them
+    scheduler->worker_count = workers;
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&scheduler->workers[i].thread, NULL, worker_loop, &scheduler->workers[i]) != 0) {
+            log_warn("Couldn't start worker %d, going on with %d.", i, i);
+            break;
+        }
+        scheduler->thread_count = i + 1;
+    }
+
+    return scheduler;
+
+error:
+    if (scheduler) {
+        // workers after the one which failed never got a deque
+        for (i = 0; scheduler->workers && i < workers; i++) {
+            if (scheduler->workers[i].deque) WSDeque_destroy(&scheduler->workers[i].deque);
+        }
+        free(scheduler->workers);
+        if (scheduler->injected) MPMCQueue_destroy(&scheduler->injected);
+        pthread_mutex_destroy(&scheduler->park_lock);
+        pthread_cond_destroy(&scheduler->park);
+        free(scheduler);
+    }
+    return NULL;
+}
+
+int Scheduler_destroy(Scheduler **scheduler)
+{
+    check(scheduler != NULL, "Somehow got reference to scheduler that is NULL.");
+    check(*scheduler != NULL, "Somehow got scheduler that is NULL.");
+
+    Scheduler *s = *scheduler;
+
+    pthread_mutex_lock(&s->park_lock);
+    atomic_store_explicit(&s->shutdown, 1, memory_order_release);
+    s->wakeups++;
+    pthread_cond_broadcast(&s->park);
+    pthread_mutex_unlock(&s->park_lock);
+
+    int i = 0;
+    for (i = 0; i < s->thread_count; i++) {
+        pthread_join(s->workers[i].thread, NULL);
+    }
+
+    // tasks nobody got to are dropped
+    Task *task = NULL;
+    for (i = 0; i < s->worker_count; i++) {
+        while ((task = WSDeque_pop(s->workers[i].deque))) free(task);
+        WSDeque_destroy(&s->workers[i].deque);
+    }
+    while ((task = MPMCQueue_try_pop(s->injected))) free(task);
+
+    MPMCQueue_destroy(&s->injected);
+    free(s->workers);
+    pthread_mutex_destroy(&s->park_lock);
+    pthread_cond_destroy(&s->park);
+    free(s);
+    *scheduler = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* spawn and wait */
+
+int Scheduler_spawn(Scheduler *scheduler, TaskGroup *group, Task_func func, void *arg)
+{
+    check(scheduler != NULL, "Somehow got scheduler that is NULL.");
+    check(group != NULL, "Somehow got group that is NULL.");
+    check(func != NULL, "Somehow got func (callback) that is NULL.");
+
+    Task *task = malloc(sizeof(Task));
+    check_mem(task);
+
+    task->func = func;
+    task->arg = arg;
+    task->group = group;
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+
+    SchedulerWorker *self = self_in(scheduler);
+    int rc = self ? WSDeque_push(self->deque, task) : MPMCQueue_try_push(scheduler->injected, task);
+    if (rc == CERB_ERR) {
+        // nowhere to put it, the spawner does it right away
+        run_task(task);
+        return CERB_OK;
+    }
+
+    wake_worker(scheduler);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Scheduler_wait(Scheduler *scheduler, TaskGroup *group)
+{
+    check(scheduler != NULL, "Somehow got scheduler that is NULL.");
+    check(group != NULL, "Somehow got group that is NULL.");
+
+    SchedulerWorker *self = self_in(scheduler);
+
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+        Task *task = find_task(scheduler, self);
+        if (task) {
+            run_task(task);
+        } else {
+            sched_yield();
+        }
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Scheduler_worker_index(Scheduler *scheduler)
+{
+    SchedulerWorker *self = self_in(scheduler);
+
+    return self ? self->index : -1;
+}
@@ -0,0 +1,64 @@
+#ifndef AA221840_4C26_4BDD_AFD9_1BF3D083DB82
+#define AA221840_4C26_4BDD_AFD9_1BF3D083DB82
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "dbg.h"
+#include "ws_deque.h"
+#include "mpmc_queue.h"
+
+// fork / join task scheduler: every worker thread owns a work stealing deque, tasks spawned by a task go to
+// its worker's deque and idle workers steal the oldest ones from random victims, so big pieces of recursive
+// work spread out first while small ones stay on the worker which made them
+// workers which find nothing to do sleep until something gets spawned
+
+// queue for tasks spawned from threads which aren't workers of the scheduler
+#define SCHEDULER_INJECT_CAPACITY 1024
+// empty rounds a worker makes before going to sleep
+#define SCHEDULER_SPINS 64
+
+typedef void (*Task_func) (void *arg);
+
+// tasks spawned into the same group can be waited for together
+typedef struct TaskGroup {
+    atomic_int pending;
+} TaskGroup;
+
+typedef struct SchedulerWorker {
+    struct Scheduler *scheduler;
+    WSDeque *deque;
+    pthread_t thread;
+    int index;
+} SchedulerWorker;
+
+typedef struct Scheduler {
+    int worker_count;
+    int thread_count; // workers whose thread actually started
+    SchedulerWorker *workers;
+    MPMCQueue *injected;
+    atomic_int shutdown;
+    atomic_int sleepers;
+    pthread_mutex_t park_lock;
+    pthread_cond_t park;
+    uint64_t wakeups; // guarded by park_lock
+} Scheduler;
+
+// start a scheduler with workers worker threads, 0 workers is fine too ( tasks then run in Scheduler_wait )
+Scheduler *Scheduler_create(int workers);
+// run func(arg) on some thread later, group counts it as pending until it returns
+int Scheduler_spawn(Scheduler *scheduler, TaskGroup *group, Task_func func, void *arg);
+// return once every task of group is done, the waiting thread runs other tasks meanwhile
+int Scheduler_wait(Scheduler *scheduler, TaskGroup *group);
+// index of the calling thread among scheduler's workers, -1 if it isn't one of them
+int Scheduler_worker_index(Scheduler *scheduler);
+
+// stop and free the scheduler, no task should be pending anymore
+// pass a reference to make it NULL after freeing
+int Scheduler_destroy(Scheduler **scheduler);
+
+#define TaskGroup_init(G) atomic_init(&(G)->pending, 0)
+
+#endif /* AA221840_4C26_4BDD_AFD9_1BF3D083DB82 */
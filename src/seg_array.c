@@ -0,0 +1,140 @@
+#include "seg_array.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* segment arithmetic */
+
+// index i lives in segment msb(i + first) - FIRST_SHIFT, at offset (i + first) without its msb
+static inline int SegArray_locate(size_t i, size_t *offset)
+{
+    uint64_t j = (uint64_t) i + ((uint64_t) 1 << SEG_ARRAY_FIRST_SHIFT);
+    int msb = 63 - __builtin_clzll(j);
+
+    *offset = (size_t) (j - ((uint64_t) 1 << msb));
+
+    return msb - SEG_ARRAY_FIRST_SHIFT;
+}
+
+static inline size_t SegArray_segment_size(int segment)
+{
+    return (size_t) 1 << (segment + SEG_ARRAY_FIRST_SHIFT);
+}
+
+/* create */
+
+SegArray *SegArray_create(void)
+{
+    SegArray *array = aligned_alloc(64, sizeof(SegArray));
+    check_mem(array);
+
+    memset(array, 0, sizeof(SegArray));
+    atomic_init(&array->length, 0);
+
+    return array;
+
+error:
+    return NULL;
+}
+
+// first pusher to reach an empty segment allocates it, the ones who lose the race free theirs
+static _Atomic(void *) *SegArray_add_segment(SegArray *array, int segment)
+{
+    _Atomic(void *) *expected = NULL;
+    _Atomic(void *) *fresh = calloc(SegArray_segment_size(segment), sizeof(_Atomic(void *)));
+    check_mem(fresh);
+
+    if (atomic_compare_exchange_strong_explicit(&array->segments[segment], &expected, fresh,
+                memory_order_acq_rel, memory_order_acquire)) {
+        return fresh;
+    }
+    free(fresh);
+
+    return expected;
+
+error:
+    return NULL;
+}
+
+/* push and get */
+
+int SegArray_push(SegArray *array, void *data, size_t *index)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    size_t i = atomic_fetch_add_explicit(&array->length, 1, memory_order_relaxed);
+    size_t offset = 0;
+    int segment = SegArray_locate(i, &offset);
+    check(segment < SEG_ARRAY_SEGMENTS, "array has reached it's max length.");
+
+    _Atomic(void *) *slots = atomic_load_explicit(&array->segments[segment], memory_order_acquire);
+    if (!slots) {
+        slots = SegArray_add_segment(array, segment);
+        check(slots != NULL, "Couldn't add segment, position %zu stays empty.", i);
+    }
+
+    // release pairs with acquire in SegArray_get, whatever data points to is visible to the reader
+    atomic_store_explicit(&slots[offset], data, memory_order_release);
+
+    if (index) *index = i;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *SegArray_get(SegArray *array, size_t i)
+{
+    check(array != NULL, "Somehow got array that is NULL.");
+
+    size_t offset = 0;
+    int segment = SegArray_locate(i, &offset);
+    if (segment >= SEG_ARRAY_SEGMENTS) return NULL;
+
+    _Atomic(void *) *slots = atomic_load_explicit(&array->segments[segment], memory_order_acquire);
+    if (!slots) return NULL;
+
+    return atomic_load_explicit(&slots[offset], memory_order_acquire);
+
+error:
+    return NULL;
+}
+
+/* freeing operations */
+
+int SegArray_destroy(SegArray **array)
+{
+    check(array != NULL, "Somehow got address of array that is NULL.");
+    check(*array != NULL, "Somehow got array that is NULL.");
+
+    int i = 0;
+    for (i = 0; i < SEG_ARRAY_SEGMENTS; i++) {
+        free(atomic_load_explicit(&(*array)->segments[i], memory_order_acquire));
+    }
+    free(*array);
+    *array = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int SegArray_free_complex_data(SegArray **array, free_func handler_func)
+{
+    check(array != NULL, "Somehow got address of array that is NULL.");
+    check(*array != NULL, "Somehow got array that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func (callback) that is NULL.");
+
+    size_t i = 0, length = SegArray_length(*array);
+    for (i = 0; i < length; i++) {
+        void *data = SegArray_get(*array, i);
+        if (data) handler_func(data);
+    }
+
+    return SegArray_destroy(array);
+
+error:
+    return CERB_ERR;
+}
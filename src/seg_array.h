@@ -0,0 +1,45 @@
+#ifndef B3AB2841_F95B_48D2_A678_9C6320236081
+#define B3AB2841_F95B_48D2_A678_9C6320236081
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dbg.h"
+
+typedef void (*free_func) (void *data);
+
+// first segment holds 1 << SEG_ARRAY_FIRST_SHIFT elements and every next one is twice as big as previous
+#define SEG_ARRAY_FIRST_SHIFT 6
+#define SEG_ARRAY_SEGMENTS 40
+
+// append only array which many threads can push to and read from at the same time without locks
+// elements live in segments which are never moved or freed until the array is destroyed,
+// so pointers to them and elements already read stay valid while others push
+typedef struct SegArray {
+    // reserved indices, pushers take theirs with one fetch add ( kept on its own cache line )
+    _Alignas(64) atomic_size_t length;
+    _Alignas(64) _Atomic(_Atomic(void *) *) segments[SEG_ARRAY_SEGMENTS];
+} SegArray;
+
+// create an empty SegArray ( no segment is allocated until the first push )
+SegArray *SegArray_create(void);
+// push data at the end, if index isn't NULL position data got written at is stored there
+// safe to call from many threads at once
+int SegArray_push(SegArray *array, void *data, size_t *index);
+// get data at position i, NULL if i isn't pushed yet or its push hasn't finished writing
+// safe to call from many threads at once, also while others push
+void *SegArray_get(SegArray *array, size_t i);
+
+// free the array and its segments ( THIS DOES NOT FREE THE DATA IN IT )
+// nobody should be using the array anymore, pass a reference to make it NULL after freeing
+int SegArray_destroy(SegArray **array);
+// apply handler_func to every element and then SegArray_destroy
+int SegArray_free_complex_data(SegArray **array, free_func handler_func);
+
+// how many positions have been reserved by pushes so far
+#define SegArray_length(A) atomic_load_explicit(&(A)->length, memory_order_acquire)
+
+#endif /* B3AB2841_F95B_48D2_A678_9C6320236081 */
@@ -23,9 +23,35 @@ error:
     return NULL;
 }
 
-static inline SLinkedNode *SLinkedNode_create()
+SLinked *SLinked_create_pooled(SLinked_cmp cmp, NodePool *pool)
 {
-    SLinkedNode *node = calloc(1, sizeof(SLinkedNode));
+    SLinked *list = SLinked_create(cmp);
+    check(list != NULL, "Failed to create list.");
+
+    if (pool) {
+        check(pool->node_size >= sizeof(SLinkedNode), "Pool's nodes are too small for SLinkedNode.");
+        list->pool = NodePool_retain(pool);
+    } else {
+        list->pool = NodePool_create(sizeof(SLinkedNode), 0);
+    }
+    check(list->pool != NULL, "Failed to get a pool for list.");
+
+    return list;
+
+error:
+    free(list);
+    return NULL;
+}
+
+// new empty list which takes nodes from the same place as list does
+static inline SLinked *SLinked_create_like(SLinked *list)
+{
+    return list->pool ? SLinked_create_pooled(list->cmp_template, list->pool) : SLinked_create(list->cmp_template);
+}
+
+static inline SLinkedNode *SLinkedNode_create(SLinked *list)
+{
+    SLinkedNode *node = list->pool ? NodePool_alloc(list->pool) : calloc(1, sizeof(SLinkedNode));
     check_mem(node);
 
     return node;
@@ -34,6 +60,35 @@ error:
     return NULL;
 }
 
+static inline void SLinkedNode_destroy(SLinked *list, SLinkedNode *node)
+{
+    if (list->pool) {
+        NodePool_free(list->pool, node);
+    } else {
+        free(node);
+    }
+}
+
+// free every node and list itself, handler_func ( if there's one ) gets each node's data first
+static void SLinked_free_all(SLinked *list, free_func handler_func)
+{
+    // if nobody else uses the pool its slabs go all at once, nodes don't have to be given back one by one
+    int drop_nodes = list->pool && NodePool_sole_user(list->pool);
+
+    if (handler_func || !drop_nodes) {
+        SLinkedNode *cur_node = list->first;
+        while (cur_node) {
+            SLinkedNode *next_node = cur_node->next;
+            if (handler_func) handler_func(cur_node->data);
+            if (!drop_nodes) SLinkedNode_destroy(list, cur_node);
+            cur_node = next_node;
+        }
+    }
+
+    if (list->pool) NodePool_release(&list->pool);
+    free(list);
+}
+
 /* __insert operations */
 
 // here we always __insert after *cur if it is NULL we make new node as the first element
@@ -76,21 +131,18 @@ int SLinked_push(SLinked *list, void *data)
     check(data != NULL, "Somehow got data that is NULL.");
     check(list->count <= UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
 
-    SLinkedNode *new_node = SLinkedNode_create();
+    SLinkedNode *new_node = SLinkedNode_create(list);
     check(new_node != NULL, "Failed to create new node.");
 
     new_node->data = data;
     new_node->next = NULL;
 
-    // if list->first is NULL we skip this loop and __insert the first element
-    SLinked_iter (list, cur) {
-        if (!cur->next) {
-            cur->next = new_node;
-            list->count++;
-            return CERB_OK;
-        }
+    if (list->last) {
+        list->last->next = new_node;
+    } else {
+        list->first = new_node;
     }
-    list->first = new_node;
+    list->last = new_node;
     list->count++;
 
     return CERB_OK;
@@ -99,18 +151,67 @@ error:
     return CERB_ERR;
 }
 
+int SLinked_push_many(SLinked *list, void **data, uint32_t count)
+{
+    SLinkedNode *first = NULL;
+    SLinkedNode *last = NULL;
+
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(data != NULL || count == 0, "Somehow got data that is NULL.");
+    check((uint64_t) list->count + count <= UINT32_MAX,
+    "Couldn't push as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
+
+    if (count == 0) return CERB_OK;
+
+    // link the chain up on the side, the list only changes once it is complete
+    uint32_t i = 0;
+    for (i = 0; i < count; i++) {
+        check(data[i] != NULL, "Somehow got data that is NULL.");
+
+        SLinkedNode *new_node = SLinkedNode_create(list);
+        check(new_node != NULL, "Failed to create new node.");
+        new_node->data = data[i];
+
+        if (last) {
+            last->next = new_node;
+        } else {
+            first = new_node;
+        }
+        last = new_node;
+    }
+
+    if (list->last) {
+        list->last->next = first;
+    } else {
+        list->first = first;
+    }
+    list->last = last;
+    list->count += count;
+
+    return CERB_OK;
+
+error:
+    while (first) {
+        SLinkedNode *next = first->next;
+        SLinkedNode_destroy(list, first);
+        first = next;
+    }
+    return CERB_ERR;
+}
+
 int SLinked_unshift(SLinked *list, void *data)
 {
     check(list != NULL, "Somehow got list that is NULL.");
     check(data != NULL, "Somehow got data that is NULL.");
     check(list->count <= UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
 
-    SLinkedNode *new_node = SLinkedNode_create();
+    SLinkedNode *new_node = SLinkedNode_create(list);
     check(new_node != NULL, "Failed to create new node.");
 
     new_node->data = data;
     new_node->next = list->first;
     list->first = new_node;
+    if (!list->last) list->last = new_node;
     list->count++;
 
     return CERB_OK;
@@ -119,6 +220,8 @@ error:
     return CERB_ERR;
 }
 
+#ifdef CERB_DEBUG_LISTS
+
 static inline int in_list(SLinked *list, SLinkedNode *node) // checks if node is in given list
 {
     SLinked_iter (list, cur) {
@@ -130,6 +233,17 @@ static inline int in_list(SLinked *list, SLinkedNode *node) // checks if node is
     return 0;
 }
 
+#else
+
+// a node doesn't know its list and there is nothing to check in O(1), so we trust the caller
+static inline int in_list(SLinked *list, SLinkedNode *node)
+{
+    (void) list;
+    return node != NULL;
+}
+
+#endif
+
 int SLinked_insert_after(SLinked *list, SLinkedNode *after, void *data)
 {
     check(list != NULL, "Somehow got list that is NULL.");
@@ -138,12 +252,13 @@ int SLinked_insert_after(SLinked *list, SLinkedNode *after, void *data)
     check(list->count <= UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
 
     if (in_list(list, after)) {
-        SLinkedNode *new_node = SLinkedNode_create();
+        SLinkedNode *new_node = SLinkedNode_create(list);
         check(new_node != NULL, "Failed to create new node.");
 
         new_node->data = data;
         new_node->next = after->next;
         after->next = new_node;
+        if (after == list->last) list->last = new_node;
         list->count++;
         return CERB_OK;
     }
@@ -165,7 +280,7 @@ int SLinked_insert_before(SLinked *list, SLinkedNode *before, void *data)
     // confirm that *after is indeed in this list
     SLinked_iter (list, cur) {
         if (cur->next == before) {                
-            SLinkedNode *new_node = SLinkedNode_create();
+            SLinkedNode *new_node = SLinkedNode_create(list);
             check(new_node != NULL, "Failed to create new node.");
 
             new_node->data = data;
@@ -222,18 +337,20 @@ void *SLinked_pop(SLinked *list)
     if (list->count == 1) {
         // means we are removing the one and only element 
         rc = list->first->data;
-        free(list->first);
+        SLinkedNode_destroy(list, list->first);
         list->first = NULL;
+        list->last = NULL;
         list->count = 0; // or --; as list gets empty
     } else {
-        SLinked_iter (list, cur) {
-            if (!cur->next->next) { // delete after cur
-                rc = cur->next->data;
-                free(cur->next);
-                cur->next = NULL;
-                list->count--;
-            }
-        }
+        // we still have to find the node before last, but we stop as soon as we do
+        SLinkedNode *cur = list->first;
+        while (cur->next != list->last) cur = cur->next;
+
+        rc = list->last->data;
+        SLinkedNode_destroy(list, list->last);
+        cur->next = NULL;
+        list->last = cur;
+        list->count--;
     }
 
 error: // fall through
@@ -250,7 +367,8 @@ void *SLinked_shift(SLinked *list)
         rc = list->first->data;
         SLinkedNode *first_node = list->first; // not to loose or insta free the pointer
         list->first = list->first->next;
-        free(first_node);
+        if (!list->first) list->last = NULL;
+        SLinkedNode_destroy(list, first_node);
         list->count--;
         return rc;
     }
@@ -272,7 +390,8 @@ void *SLinked_remove(SLinked *list, SLinkedNode *node)
     if (node == list->first) {
         rc = node->data;
         list->first = node->next;
-        free(node);
+        if (node == list->last) list->last = NULL;
+        SLinkedNode_destroy(list, node);
         list->count--;
         return rc;
     }
@@ -281,7 +400,8 @@ void *SLinked_remove(SLinked *list, SLinkedNode *node)
         if (cur->next == node) {
             rc = node->data;
             cur->next = node->next;
-            free(node);
+            if (node == list->last) list->last = cur;
+            SLinkedNode_destroy(list, node);
             list->count--;
             return rc;
         }
@@ -304,7 +424,8 @@ void *SLinked_remove_after(SLinked *list, SLinkedNode *after)
         rc = after->next->data;
         SLinkedNode *after_next = after->next; // not to loose or insta free the pointer
         after->next = after->next->next;
-        free(after_next);
+        if (after_next == list->last) list->last = after;
+        SLinkedNode_destroy(list, after_next);
         list->count--;
         return rc;
     }
@@ -335,7 +456,7 @@ void *SLinked_remove_before(SLinked *list, SLinkedNode *before)
                 rc = cur->next->data;
                 SLinkedNode *cur_next = cur->next;  // not to loose or insta free the pointer
                 cur->next = before;
-                free(cur_next);
+                SLinkedNode_destroy(list, cur_next);
                 list->count--;
                 return rc;
             }
@@ -362,15 +483,13 @@ int SLinked_join(SLinked **list1, SLinked **list2)
     check((*list1)->count + (*list2)->count <= UINT32_MAX,
     "Couldn't join lists as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
     check((*list1)->cmp_template == (*list2)->cmp_template, "Couldn't join lists of different cmp_templates");
+    check((*list1)->pool == (*list2)->pool, "Couldn't join lists which take nodes from different pools.");
 
-    SLinked_iter (*list1, cur) {
-        if (!cur->next) {
-            cur->next = (*list2)->first;
-            (*list1)->count += (*list2)->count;
-            break;
-        }
-    }
+    (*list1)->last->next = (*list2)->first;
+    (*list1)->last = (*list2)->last;
+    (*list1)->count += (*list2)->count;
 
+    if ((*list2)->pool) NodePool_release(&(*list2)->pool);
     free(*list2);
     *list2 = NULL;
     
@@ -406,10 +525,11 @@ SLinked *SLinked_split(SLinked **list, SLinkedNode *from_node, SLinkedNode *to_n
             if (cur == to_node) {
                 check(cur->next, "Doesn't make sense to split from first including last.");
 
-                new_list = SLinked_create((*list)->cmp_template);
+                new_list = SLinked_create_like(*list);
                 check(new_list != NULL, "Couldn't create new list.");
 
                 new_list->first = (*list)->first;
+                new_list->last = cur;
                 (*list)->first = cur->next;
                 cur->next = NULL;
                 new_list->count = count;
@@ -425,11 +545,13 @@ SLinked *SLinked_split(SLinked **list, SLinkedNode *from_node, SLinkedNode *to_n
             count++;
 
             if (cur->next == from_node) {
-                new_list = SLinked_create((*list)->cmp_template);
+                new_list = SLinked_create_like(*list);
                 check(new_list != NULL, "Couldn't create new list.");
 
                 new_list->first = from_node;
+                new_list->last = (*list)->last;
                 cur->next = NULL;
+                (*list)->last = cur;
                 new_list->count = (*list)->count - count;
                 (*list)->count = count;
                 return new_list;
@@ -446,9 +568,11 @@ SLinked *SLinked_split(SLinked **list, SLinkedNode *from_node, SLinkedNode *to_n
         // if we are splitting not from the first to not to the last
         SLinked_iter (*list, cur) {
             if (cur->next == from_node) {
-                new_list = SLinked_create((*list)->cmp_template);
+                new_list = SLinked_create_like(*list);
                 check(new_list != NULL, "Couldn't create new list.");
                 new_list->first = from_node;
+                new_list->last = to_node;
+                if (to_node == (*list)->last) (*list)->last = cur;
                 cur->next = to_node->next; // move link to to node's next element
                 to_node->next = NULL; // set this to NULL as it becomes the last element of new list
 
@@ -494,20 +618,8 @@ int SLinked_destroy(SLinked **list) // pass by reference to make it NULL, so no
 {
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
-    
-    if (!(*list)->count) goto empty_list; // if list is empty skip the loop
-
-    SLinkedNode *cur_node = (*list)->first;
-    SLinkedNode *next_node = NULL;
-    
-    for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
-        free(cur_node);
-        cur_node = next_node;
-    }
-    free(cur_node); // free the last one and we are done
 
-empty_list: // fall through
-    free(*list);
+    SLinked_free_all(*list, NULL);
     *list = NULL;
 
     return CERB_OK;
@@ -521,21 +633,7 @@ int SLinked_clear_destroy(SLinked **list) // pass by reference to make it NULL s
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
 
-    if (!(*list)->count) goto empty_list; // if list is empty skip the loop
-
-    SLinkedNode *cur_node = (*list)->first;
-    SLinkedNode *next_node = NULL; // pottential bug here
-    
-    for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
-        free(cur_node->data);
-        free(cur_node);
-        cur_node = next_node;
-    }
-    free(cur_node->data);
-    free(cur_node); // free the last one and we are done
-
-empty_list: // fall through
-    free(*list);
+    SLinked_free_all(*list, free);
     *list = NULL;
 
     return CERB_OK;
@@ -548,22 +646,9 @@ int SLinked_free_complex_data(SLinked **list, free_func handler_func)
 {
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
 
-    if (!(*list)->count) goto empty_list; // if list is empty skip the loop
-
-    SLinkedNode *cur_node = (*list)->first;
-    SLinkedNode *next_node = NULL; // pottential bug here
-    
-    for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
-        handler_func(cur_node->data);
-        free(cur_node);
-        cur_node = next_node;
-    }
-    handler_func(cur_node->data);
-    free(cur_node); // free the last one and we are done
-
-empty_list: // fall through
-    free(*list);
+    SLinked_free_all(*list, handler_func);
     *list = NULL;
 
     return CERB_OK;
@@ -577,12 +662,7 @@ int SLinked_free_list(SLinked **list)
     check(list != NULL, "Somehow got an address of the list that is NULL.");
     check(*list != NULL, "Somehow got list that is NULL.");
 
-    SLinked_iter (*list, cur) {
-        free(cur);
-    }
-
-    free(*list);
-
+    SLinked_free_all(*list, NULL);
     *list = NULL;
 
     return CERB_OK;
@@ -602,7 +682,14 @@ int SLinked_sorted_insert(SLinked *list, void *data) // see if you can optimise
 
     // this function is optimisable by a lot but if i do
     // code becomes very ugly and hard to understand so i'll leave it as is
-    
+
+    // data which goes at the end ( e.g. when inserting in order ) doesn't need a walk
+    if (!list->last || list->cmp_template(list->last->data, data) <= 0) {
+        rc = SLinked_push(list, data);
+        check(rc != CERB_ERR, "Failed to sorted_insert.");
+        return rc;
+    }
+
     SLinked_iter (list, cur) {
         if (list->cmp_template(cur->data, data) > 0) {
             rc = SLinked_insert_before(list, cur, data);
@@ -612,8 +699,110 @@ int SLinked_sorted_insert(SLinked *list, void *data) // see if you can optimise
     }
     // if all insert_before attampts fail it means that we have to insert at the end
     rc = SLinked_push(list, data);
-    check(rc, "Failed to sorted_insert.");
+    check(rc != CERB_ERR, "Failed to sorted_insert.");
 
 error:
     return rc;
-}
\ No newline at end of file
+}
+/* sorting */
+
+// cut the non-decreasing run starting at start off the rest of the chain and return the rest
+static inline SLinkedNode *cut_run(SLinked_cmp cmp, SLinkedNode *start)
+{
+    SLinkedNode *cur = start;
+    while (cur->next && cmp(cur->data, cur->next->data) <= 0) cur = cur->next;
+
+    SLinkedNode *rest = cur->next;
+    cur->next = NULL;
+    return rest;
+}
+
+// merge sorted chains a and b, on ties a goes first so equal elements keep their order
+// *tail gets the last node of the merged chain
+static SLinkedNode *merge_chains(SLinked_cmp cmp, SLinkedNode *a, SLinkedNode *b, SLinkedNode **tail)
+{
+    SLinkedNode head = { NULL, NULL };
+    SLinkedNode *cur = &head;
+
+    while (a && b) {
+        if (cmp(b->data, a->data) < 0) {
+            cur->next = b;
+            b = b->next;
+        } else {
+            cur->next = a;
+            a = a->next;
+        }
+        cur = cur->next;
+    }
+
+    cur->next = a ? a : b;
+    while (cur->next) cur = cur->next;
+
+    *tail = cur;
+    return head.next;
+}
+
+int SLinked_sort(SLinked *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    if (list->count < 2) return CERB_OK;
+
+    // every pass merges neighbouring runs pairwise, so already sorted stretches cost nothing extra
+    uint32_t runs = 0;
+    do {
+        SLinkedNode head = { NULL, NULL };
+        SLinkedNode *tail = &head;
+        SLinkedNode *rest = list->first;
+        runs = 0;
+
+        while (rest) {
+            SLinkedNode *a = rest;
+            rest = cut_run(list->cmp_template, a);
+            SLinkedNode *b = rest;
+            if (b) rest = cut_run(list->cmp_template, b);
+
+            SLinkedNode *merged_tail = NULL;
+            tail->next = merge_chains(list->cmp_template, a, b, &merged_tail);
+            tail = merged_tail;
+            runs++;
+        }
+
+        list->first = head.next;
+        list->last = tail;
+    } while (runs > 1);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int SLinked_merge_sorted(SLinked **list1, SLinked **list2)
+{
+    check(list1 != NULL, "Somehow got an address of the list1 that is NULL.");
+    check(*list1 != NULL, "Somehow got list1 that is NULL.");
+    check(list2 != NULL, "Somehow got an address of the list2 that is NULL.");
+    check(*list2 != NULL, "Somehow got list2 that is NULL.");
+    check(*list1 != *list2, "Couldn't merge list with itself.");
+    check((uint64_t) (*list1)->count + (*list2)->count <= UINT32_MAX,
+    "Couldn't merge lists as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
+    check((*list1)->cmp_template == (*list2)->cmp_template, "Couldn't merge lists of different cmp_templates");
+    check((*list1)->pool == (*list2)->pool, "Couldn't merge lists which take nodes from different pools.");
+
+    if ((*list2)->count) {
+        SLinkedNode *tail = NULL;
+        (*list1)->first = merge_chains((*list1)->cmp_template, (*list1)->first, (*list2)->first, &tail);
+        (*list1)->last = tail;
+        (*list1)->count += (*list2)->count;
+    }
+
+    if ((*list2)->pool) NodePool_release(&(*list2)->pool);
+    free(*list2);
+    *list2 = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
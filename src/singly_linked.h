@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include "dbg.h"
+#include "node_pool.h"
 
 typedef int (*SLinked_cmp) (const void *data1, const void *data2);
 typedef void (*free_func) (void *data);
@@ -17,21 +18,34 @@ typedef struct SLinkedNode {
 
 typedef struct SLinked {
     SLinkedNode *first;
+    SLinkedNode *last; // kept so push and join don't have to walk the list
     // this is for sorting (if you'll need) when creating list you can pass NULL and default cmp will be set
     SLinked_cmp cmp_template;
     uint32_t count;
+    NodePool *pool; // where nodes come from, NULL if every node is malloc'd on its own
 } SLinked;
 
 // create SLinked *list ( specify cmp if you need to sorted insert )
 SLinked *SLinked_create(SLinked_cmp cmp); //
+// create SLinked *list which takes its nodes from pool ( sizeof(SLinkedNode) byte nodes ), pass NULL to give it its own pool
+// lists can share a pool, destroying the last one using it frees whole slabs instead of single nodes
+// only lists with the same pool can be joined, split gives back a list with the same pool
+SLinked *SLinked_create_pooled(SLinked_cmp cmp, NodePool *pool);
 // push data in list
 int SLinked_push(SLinked *list, void *data); //
-// pop data from list and return
+// push count elements of data in order, they are linked up first and appended in one step
+// ( if a node can't be created nothing gets pushed )
+int SLinked_push_many(SLinked *list, void **data, uint32_t count);
+// pop data from list and return ( still walks the list, a singly linked node doesn't know who's before it )
 void *SLinked_pop(SLinked *list); //
 // insert data at first position in list
 int SLinked_unshift(SLinked *list, void *data); //
 // remove first entry from list and return
 void *SLinked_shift(SLinked *list); //
+// insert_after, remove_after and split trust that the nodes you pass are in list ( no scan, O(1) )
+// all they check is that the node isn't NULL, a node of another list or a freed one is undefined behaviour
+// build with CERB_DEBUG_LISTS ( make dev does ) to have them looked up in the list
+// the other calls taking a node still walk the list, they need the node before it
 // remove SLinkedNode *node from list and return
 void *SLinked_remove(SLinked *list, SLinkedNode *node); //
 // insert data after SLinkedNode *after
@@ -68,6 +82,11 @@ int SLinked_free_list(SLinked **list); // to free just list and its nodes, but n
 
 // sorted insert in list ( SHOULD BE INSERTED WITH THIS FUNCTION ONLY, IF YOU WANT TO HAVE SORTED ARRAY )
 int SLinked_sorted_insert(SLinked *list, void *data);
+// sort list in place with cmp_template ( stable, O(n log n), allocates nothing )
+// natural merge sort, so lists which are already mostly in order sort in close to one pass
+int SLinked_sort(SLinked *list);
+// merge sorted list2 into sorted list1 in one pass and free list2 ( same rules as join ), provide references to them
+int SLinked_merge_sorted(SLinked **list1, SLinked **list2);
 
 // L is SLinked *list
 // C is current node's name you want it to have
@@ -105,6 +124,7 @@ int SLinked_sorted_insert(SLinked *list, void *data);
     if (list) {\
         if (list->count > 1) {\
             SLinkedNode *first = list->first;\
+            list->last = first;\
             SLinkedNode *second = first->next;\
             first->next = NULL; /* NULL out first->next as it will become last->next */\
             SLinkedNode *third = second->next;\
@@ -0,0 +1,322 @@
+#include "skip_list.h"
+#include <stdlib.h>
+#include <string.h>
+
+static inline int default_compare(const void *a, const void *b)
+{
+    return strcmp((char *) a, (char *) b);
+}
+
+// xorshift, levels only need to look random, not be unpredictable
+static inline uint64_t next_random(SkipList *list)
+{
+    list->seed ^= list->seed << 13;
+    list->seed ^= list->seed >> 7;
+    list->seed ^= list->seed << 17;
+
+    return list->seed;
+}
+
+// one more level for every pair of zero bits, so each level has a quarter of the nodes of the one below
+static inline uint32_t random_level(SkipList *list)
+{
+    uint64_t bits = next_random(list);
+    uint32_t level = 1;
+
+    while ((bits & 3) == 0 && level < SKIPLIST_MAX_LEVEL) {
+        level++;
+        bits >>= 2;
+    }
+
+    return level;
+}
+
+static SkipListNode *SkipListNode_create(uint32_t level, void *data)
+{
+    SkipListNode *node = calloc(1, sizeof(SkipListNode) + sizeof(SkipListLevel) * level);
+    check_mem(node);
+
+    node->data = data;
+    node->level = level;
+
+    return node;
+
+error:
+    return NULL;
+}
+
+/* create operations */
+
+SkipList *SkipList_create(SkipList_cmp cmp)
+{
+    SkipList *list = calloc(1, sizeof(SkipList));
+    check_mem(list);
+
+    list->head = SkipListNode_create(SKIPLIST_MAX_LEVEL, NULL);
+    check(list->head != NULL, "Failed to create head node.");
+
+    list->cmp_template = cmp == NULL ? default_compare : cmp;
+    list->level = 1;
+    list->seed = (uint64_t) (uintptr_t) list | 1;
+
+    return list;
+
+error:
+    free(list);
+    return NULL;
+}
+
+/* searching */
+
+// last node at every level that is less than key ( or not greater if after_equal ) goes in update
+// and how many elements come before it in rank, returns the node after update[0]
+static SkipListNode *find_path(SkipList *list, const void *key, int after_equal,
+        SkipListNode **update, uint32_t *rank)
+{
+    SkipListNode *cur = list->head;
+    uint32_t traversed = 0;
+    int i = 0;
+
+    for (i = (int) list->level - 1; i >= 0; i--) {
+        SkipListNode *next = cur->tower[i].next;
+        while (next) {
+            int rc = list->cmp_template(next->data, key);
+            if (rc > 0 || (rc == 0 && !after_equal)) break;
+
+            traversed += cur->tower[i].span;
+            cur = next;
+            next = cur->tower[i].next;
+        }
+
+        if (update) update[i] = cur;
+        if (rank) rank[i] = traversed;
+    }
+
+    return cur->tower[0].next;
+}
+
+SkipListNode *SkipList_lower_bound(SkipList *list, const void *key)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    return find_path(list, key, 0, NULL, NULL);
+
+error:
+    return NULL;
+}
+
+SkipListNode *SkipList_find(SkipList *list, const void *key)
+{
+    SkipListNode *node = SkipList_lower_bound(list, key);
+
+    return node && list->cmp_template(node->data, key) == 0 ? node : NULL;
+}
+
+uint32_t SkipList_rank(SkipList *list, const void *key)
+{
+    uint32_t rank[SKIPLIST_MAX_LEVEL];
+
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    find_path(list, key, 0, NULL, rank);
+    return rank[0];
+
+error:
+    return 0;
+}
+
+SkipListNode *SkipList_at(SkipList *list, uint32_t rank)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    if (rank >= list->count) return NULL;
+
+    // spans count the node they lead to, so the element at rank is rank + 1 steps from head
+    SkipListNode *cur = list->head;
+    uint64_t traversed = 0;
+    int i = 0;
+
+    for (i = (int) list->level - 1; i >= 0; i--) {
+        while (cur->tower[i].next && traversed + cur->tower[i].span <= (uint64_t) rank + 1) {
+            traversed += cur->tower[i].span;
+            cur = cur->tower[i].next;
+        }
+
+        if (traversed == (uint64_t) rank + 1) return cur;
+    }
+
+error: // fall through
+    return NULL;
+}
+
+/* insert and remove operations */
+
+SkipListNode *SkipList_insert(SkipList *list, void *data)
+{
+    SkipListNode *update[SKIPLIST_MAX_LEVEL];
+    uint32_t rank[SKIPLIST_MAX_LEVEL];
+
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    find_path(list, data, 1, update, rank);
+
+    uint32_t level = random_level(list);
+    uint32_t i = 0;
+
+    // levels nobody used yet start at head and span the whole list
+    for (i = list->level; i < level; i++) {
+        update[i] = list->head;
+        rank[i] = 0;
+        list->head->tower[i].span = list->count;
+    }
+
+    SkipListNode *node = SkipListNode_create(level, data);
+    check(node != NULL, "Failed to create new node.");
+
+    if (level > list->level) list->level = level;
+
+    for (i = 0; i < level; i++) {
+        node->tower[i].next = update[i]->tower[i].next;
+        update[i]->tower[i].next = node;
+
+        // rank[0] - rank[i] elements lie between update[i] and the new node
+        node->tower[i].span = update[i]->tower[i].span - (rank[0] - rank[i]);
+        update[i]->tower[i].span = rank[0] - rank[i] + 1;
+    }
+
+    // taller links jump over the new node now
+    for (i = level; i < list->level; i++) {
+        update[i]->tower[i].span++;
+    }
+
+    node->prev = update[0] == list->head ? NULL : update[0];
+    if (node->tower[0].next) {
+        node->tower[0].next->prev = node;
+    } else {
+        list->last = node;
+    }
+    list->count++;
+
+    return node;
+
+error:
+    return NULL;
+}
+
+static void *SkipList_unlink(SkipList *list, SkipListNode *node, SkipListNode **update)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < list->level; i++) {
+        if (update[i]->tower[i].next == node) {
+            update[i]->tower[i].span += node->tower[i].span - 1;
+            update[i]->tower[i].next = node->tower[i].next;
+        } else {
+            update[i]->tower[i].span--;
+        }
+    }
+
+    if (node->tower[0].next) {
+        node->tower[0].next->prev = node->prev;
+    } else {
+        list->last = node->prev;
+    }
+
+    while (list->level > 1 && list->head->tower[list->level - 1].next == NULL) {
+        list->level--;
+    }
+    list->count--;
+
+    void *data = node->data;
+    free(node);
+
+    return data;
+}
+
+void *SkipList_remove(SkipList *list, const void *key)
+{
+    SkipListNode *update[SKIPLIST_MAX_LEVEL];
+
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    SkipListNode *node = find_path(list, key, 0, update, NULL);
+    if (node == NULL || list->cmp_template(node->data, key) != 0) return NULL;
+
+    return SkipList_unlink(list, node, update);
+
+error:
+    return NULL;
+}
+
+void *SkipList_remove_node(SkipList *list, SkipListNode *node)
+{
+    SkipListNode *update[SKIPLIST_MAX_LEVEL];
+
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(node != NULL, "Somehow got node that is NULL.");
+
+    SkipListNode *cur = find_path(list, node->data, 0, update, NULL);
+
+    // node may have equal elements before it, every one we pass is a closer predecessor on its levels
+    while (cur != node) {
+        check(cur != NULL && list->cmp_template(cur->data, node->data) == 0, "Couldn't find node %p in list.", node);
+
+        uint32_t i = 0;
+        for (i = 0; i < cur->level; i++) {
+            update[i] = cur;
+        }
+        cur = cur->tower[0].next;
+    }
+
+    return SkipList_unlink(list, node, update);
+
+error:
+    return NULL;
+}
+
+/* destroy operations */
+
+static void SkipList_free_all(SkipList *list, free_func handler_func)
+{
+    SkipListNode *node = list->head;
+
+    while (node) {
+        SkipListNode *next = node->tower[0].next;
+        if (handler_func && node != list->head) handler_func(node->data);
+        free(node);
+        node = next;
+    }
+
+    free(list);
+}
+
+int SkipList_destroy(SkipList **list)
+{
+    check(list != NULL, "Somehow got an address of the list that is NULL.");
+    check(*list != NULL, "Somehow got list that is NULL.");
+
+    SkipList_free_all(*list, NULL);
+    *list = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int SkipList_free_complex_data(SkipList **list, free_func handler_func)
+{
+    check(list != NULL, "Somehow got an address of the list that is NULL.");
+    check(*list != NULL, "Somehow got list that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    SkipList_free_all(*list, handler_func);
+    *list = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
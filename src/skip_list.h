@@ -0,0 +1,91 @@
+#ifndef AD102D4B_7F73_4743_9493_2527E4ED5F39
+#define AD102D4B_7F73_4743_9493_2527E4ED5F39
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stdint.h>
+#include "dbg.h"
+
+typedef int (*SkipList_cmp) (const void *data1, const void *data2);
+typedef void (*free_func) (void *data);
+
+// tallest tower a node can get, enough for far more than UINT32_MAX elements with p = 1/4
+#define SKIPLIST_MAX_LEVEL 32
+
+typedef struct SkipListLevel {
+    struct SkipListNode *next;
+    uint32_t span; // how many elements forward next is, rank queries add these up
+} SkipListLevel;
+
+// tower is allocated together with the node, a node of level n has n entries in it
+typedef struct SkipListNode {
+    void *data;
+    struct SkipListNode *prev; // level 0 only, NULL for the first element
+    uint32_t level;
+    SkipListLevel tower[];
+} SkipListNode;
+
+// ordered container, insert, find and remove are O(log n) on average
+// every node gets one more level with probability 1/4, levels let searches skip over most of the list
+// equal elements are kept in insertion order
+typedef struct SkipList {
+    SkipListNode *head; // sentinel with a full tower, holds no data
+    SkipListNode *last;
+    SkipList_cmp cmp_template; // when creating list you can pass NULL and default cmp will be set
+    uint32_t count;
+    uint32_t level; // tallest tower in the list right now
+    uint64_t seed;
+} SkipList;
+
+// create SkipList *list ordered by cmp
+SkipList *SkipList_create(SkipList_cmp cmp);
+
+// insert data in order ( after elements equal to it ) and return its node
+SkipListNode *SkipList_insert(SkipList *list, void *data);
+// first node equal to key, NULL if there's none
+SkipListNode *SkipList_find(SkipList *list, const void *key);
+// first node not less than key, NULL if every element is less ( range scans start here )
+SkipListNode *SkipList_lower_bound(SkipList *list, const void *key);
+// remove first element equal to key and return its data, NULL if there's none
+void *SkipList_remove(SkipList *list, const void *key);
+// remove node and return its data
+void *SkipList_remove_node(SkipList *list, SkipListNode *node);
+
+// node at position rank ( 0 is the smallest ), NULL if rank >= count
+SkipListNode *SkipList_at(SkipList *list, uint32_t rank);
+// how many elements are less than key ( position key would be inserted at if there are no equal ones )
+uint32_t SkipList_rank(SkipList *list, const void *key);
+
+// free list and its nodes but not data it contains, always pass a reference to make it NULL after freeing
+int SkipList_destroy(SkipList **list);
+// if data structure, which nodes contain is complex (for example struct containing pointers)
+// use this function which iterates through list and applies your handler_func to all of it's *data fields
+int SkipList_free_complex_data(SkipList **list, free_func handler_func);
+
+#define SkipList_get_count(list) (list)->count
+#define SkipList_first(list) ((list)->head->tower[0].next)
+#define SkipList_next(node) ((node)->tower[0].next)
+
+// iterate through list in order
+// L is SkipList *list, C is current node's name you want it to have
+#define SkipList_iter(L, C) SkipListNode *_node = NULL; SkipListNode *C = NULL;\
+        for (C = _node = SkipList_first(L); _node != NULL; _node = C = _node->tower[0].next)
+
+// iterate through elements which are not less than low and less than high ( low <= data < high )
+// L is SkipList *list, C is current node's name you want it to have
+#define SkipList_range(L, low, high, C) SkipListNode *C = NULL;\
+        for (C = SkipList_lower_bound(L, low); C != NULL && (L)->cmp_template(C->data, high) < 0; C = C->tower[0].next)
+
+// list is SkipList *list
+// _data is a function pointer returning anything that matches format ( %s %d %u ) etc.
+// format is "%s", "%d" ...
+#define SkipList_print(list, _data, format) if (list) {\
+            printf("\n[ ");\
+            SkipList_iter (list, cur) { printf((format " -> "), _data(cur->data)); }\
+            printf("NULL ]\n");\
+        } else {\
+            log_err("Somehow got list that is NULL.");\
+        }
+
+#endif /* AD102D4B_7F73_4743_9493_2527E4ED5F39 */
@@ -0,0 +1,127 @@
+#include "spsc_queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+SPSCQueue *SPSCQueue_create(size_t capacity)
+{
+    SPSCQueue *queue = NULL;
+
+    check(capacity > 0 && capacity <= ((size_t) 1 << 40), "Capacity %zu is out of range.", capacity);
+
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    queue = aligned_alloc(64, sizeof(SPSCQueue));
+    check_mem(queue);
+    memset(queue, 0, sizeof(SPSCQueue));
+
+    queue->mask = size - 1;
+    queue->slots = aligned_alloc(64, sizeof(void *) * size);
+    check_mem(queue->slots);
+
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+
+    return queue;
+
+error:
+    if (queue) free(queue);
+    return NULL;
+}
+
+int SPSCQueue_destroy(SPSCQueue **queue)
+{
+    check(queue != NULL, "Somehow got reference to queue that is NULL.");
+    check(*queue != NULL, "Somehow got queue that is NULL.");
+
+    free((*queue)->slots);
+    free(*queue);
+    *queue = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* batches */
+
+void **SPSCQueue_reserve(SPSCQueue *queue, size_t wanted, size_t *granted)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(granted != NULL, "Somehow got granted that is NULL.");
+
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t capacity = queue->mask + 1;
+
+    if (capacity - (tail - queue->cached_head) < wanted) {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    }
+
+    size_t free_slots = capacity - (tail - queue->cached_head);
+    size_t to_end = capacity - (tail & queue->mask);
+    size_t count = wanted < free_slots ? wanted : free_slots;
+    count = count < to_end ? count : to_end;
+
+    *granted = count;
+
+    return count ? queue->slots + (tail & queue->mask) : NULL;
+
+error:
+    return NULL;
+}
+
+int SPSCQueue_commit(SPSCQueue *queue, size_t count)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    check(count <= queue->mask + 1 - (tail - queue->cached_head), "Committing %zu slots which weren't reserved.", count);
+
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void **SPSCQueue_peek(SPSCQueue *queue, size_t *available)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+    check(available != NULL, "Somehow got available that is NULL.");
+
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t capacity = queue->mask + 1;
+
+    if (head == queue->cached_tail || capacity - (head & queue->mask) > queue->cached_tail - head) {
+        // only a fresh tail can tell whether more got pushed since the last look
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    }
+
+    size_t filled = queue->cached_tail - head;
+    size_t to_end = capacity - (head & queue->mask);
+    size_t count = filled < to_end ? filled : to_end;
+
+    *available = count;
+
+    return count ? queue->slots + (head & queue->mask) : NULL;
+
+error:
+    return NULL;
+}
+
+int SPSCQueue_release(SPSCQueue *queue, size_t count)
+{
+    check(queue != NULL, "Somehow got queue that is NULL.");
+
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    check(count <= queue->cached_tail - head, "Releasing %zu slots which weren't peeked.", count);
+
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
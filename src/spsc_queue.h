@@ -0,0 +1,81 @@
+#ifndef F41314D6_AA32_4022_99D1_047DADE0B484
+#define F41314D6_AA32_4022_99D1_047DADE0B484
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dbg.h"
+
+// bounded ring for exactly one producer thread and one consumer thread
+// each side owns its index and keeps a cached copy of the other one, the shared index is only
+// read when the cached copy says the ring looks full ( or empty ), so most operations touch no shared cache line
+// nothing on the way is a read modify write, only plain loads and stores with acquire / release
+typedef struct SPSCQueue {
+    _Alignas(64) atomic_size_t tail; // written by producer
+    size_t cached_head; // producer's last look at head
+    _Alignas(64) atomic_size_t head; // written by consumer
+    size_t cached_tail; // consumer's last look at tail
+    _Alignas(64) size_t mask;
+    void **slots;
+} SPSCQueue;
+
+// create a ring with room for capacity elements ( rounded up to a power of two )
+SPSCQueue *SPSCQueue_create(size_t capacity);
+// free the ring ( THIS DOES NOT FREE THE DATA IN IT ), pass a reference to make it NULL after freeing
+int SPSCQueue_destroy(SPSCQueue **queue);
+
+// producer: up to wanted free slots in a row to write into directly, their number goes in granted
+// ( can be less than wanted near the end of the ring or when it's nearly full, NULL when it's full )
+void **SPSCQueue_reserve(SPSCQueue *queue, size_t wanted, size_t *granted);
+// producer: hand the first count reserved slots over to the consumer
+int SPSCQueue_commit(SPSCQueue *queue, size_t count);
+// consumer: filled slots in a row to read directly, their number goes in available ( NULL when empty )
+void **SPSCQueue_peek(SPSCQueue *queue, size_t *available);
+// consumer: give the first count peeked slots back to the producer
+int SPSCQueue_release(SPSCQueue *queue, size_t count);
+
+// elements in the ring right now ( exact only when called from one of its two threads while the other is idle )
+#define SPSCQueue_length(Q) (atomic_load_explicit(&(Q)->tail, memory_order_acquire)\
+        - atomic_load_explicit(&(Q)->head, memory_order_acquire))
+
+// producer: push data, CERB_ERR if the ring is full ( or data is NULL, try_pop returns that for empty )
+static inline int SPSCQueue_try_push(SPSCQueue *queue, void *data)
+{
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    if (tail - queue->cached_head > queue->mask) {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail - queue->cached_head > queue->mask) return CERB_ERR;
+    }
+
+    queue->slots[tail & queue->mask] = data;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// consumer: pop the oldest element, NULL if the ring is empty
+static inline void *SPSCQueue_try_pop(SPSCQueue *queue)
+{
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    if (head == queue->cached_tail) {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == queue->cached_tail) return NULL;
+    }
+
+    void *data = queue->slots[head & queue->mask];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+
+    return data;
+}
+
+#endif /* F41314D6_AA32_4022_99D1_047DADE0B484 */
@@ -0,0 +1,150 @@
+#include "stack.h"
+#include <stdlib.h>
+#include <string.h>
+
+Stack *Stack_create(Stack_cmp cmp_callback)
+{
+    Stack *stack = calloc(1, sizeof(Stack));
+    check_mem(stack);
+
+    stack->cmp_template = cmp_callback;
+    stack->slots = malloc(sizeof(StackSlot) * STACK_INITIAL_CAPACITY);
+    check_mem(stack->slots);
+    stack->capacity = STACK_INITIAL_CAPACITY;
+
+    return stack;
+
+error:
+    if (stack) free(stack);
+    return NULL;
+}
+
+int Stack_reserve(Stack *stack, uint32_t capacity)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+    check(capacity <= (UINT32_C(1) << 31), "Stack can't hold more than 2^31 elements.");
+
+    if (capacity <= stack->capacity) return CERB_OK;
+
+    uint32_t new_capacity = stack->capacity;
+    while (new_capacity < capacity) new_capacity <<= 1;
+
+    StackSlot *slots = realloc(stack->slots, sizeof(StackSlot) * new_capacity);
+    check_mem(slots);
+
+    stack->slots = slots;
+    stack->capacity = new_capacity;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Stack_push(Stack *stack, void *data)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    if (stack->count == stack->capacity) {
+        int rc = Stack_reserve(stack, stack->count + 1);
+        check(rc != CERB_ERR, "Couldn't grow stack.");
+    }
+
+    stack->slots[stack->count++].data = data;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *Stack_pop(Stack *stack)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+
+    return stack->count ? stack->slots[--stack->count].data : NULL;
+
+error:
+    return NULL;
+}
+
+void *Stack_peek(Stack *stack)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+
+    return stack->count ? stack->slots[stack->count - 1].data : NULL;
+
+error:
+    return NULL;
+}
+
+int Stack_push_many(Stack *stack, void **data, uint32_t count)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+    check(data != NULL || count == 0, "Somehow got data that is NULL.");
+    check(count <= UINT32_MAX - stack->count, "Stack would be longer than UINT32_MAX.");
+
+    int rc = Stack_reserve(stack, stack->count + count);
+    check(rc != CERB_ERR, "Couldn't grow stack.");
+
+    // StackSlot is just a wrapped pointer, so the whole batch is one copy
+    memcpy(stack->slots + stack->count, data, sizeof(void *) * count);
+    stack->count += count;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Stack_pop_many(Stack *stack, void **out, uint32_t count)
+{
+    check(stack != NULL, "Somehow got stack that is NULL.");
+    check(out != NULL || count == 0, "Somehow got out that is NULL.");
+    check(count <= INT32_MAX, "Can't pop more than INT32_MAX elements at once.");
+
+    uint32_t popped = count < stack->count ? count : stack->count;
+    uint32_t i = 0;
+    for (i = 0; i < popped; i++) {
+        out[i] = stack->slots[stack->count - 1 - i].data;
+    }
+    stack->count -= popped;
+
+    return (int) popped;
+
+error:
+    return CERB_ERR;
+}
+
+int Stack_destroy(Stack **stack)
+{
+    check(stack != NULL, "Somehow got an address of the stack that is NULL.");
+    check(*stack != NULL, "Somehow got stack that is NULL.");
+
+    free((*stack)->slots);
+    free(*stack);
+    *stack = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int Stack_free_complex_data(Stack **stack, free_func handler_func)
+{
+    check(stack != NULL, "Somehow got an address of the stack that is NULL.");
+    check(*stack != NULL, "Somehow got stack that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    uint32_t i = 0;
+    for (i = 0; i < (*stack)->count; i++) {
+        handler_func((*stack)->slots[i].data);
+    }
+
+    return Stack_destroy(stack);
+
+error:
+    return CERB_ERR;
+}
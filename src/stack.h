@@ -1,33 +1,83 @@
 #ifndef DA30B4E4_4771_452B_ABA5_8E814ED70200
 #define DA30B4E4_4771_452B_ABA5_8E814ED70200
 
-#include "doubly_linked.h"
+#define CERB_OK 0
+#define CERB_ERR -1
 
-#define Stack DLinked
+#include <stdint.h>
+#include "dbg.h"
 
-// get how many elements stack has
-#define Stack_get_count(stack) DLinked_get_count(stack)
+typedef int (*Stack_cmp) (const void *data1, const void *data2);
+typedef void (*free_func) (void *data);
+
+// capacity is always a power of two, it starts here and doubles whenever stack is full
+#define STACK_INITIAL_CAPACITY 16
+
+// one element, iteration macros give you pointers to these so cur->data works like with list nodes
+typedef struct StackSlot {
+    void *data;
+} StackSlot;
+
+// stack kept in one growing array, push and pop only move count ( nothing is allocated per element )
+typedef struct Stack {
+    uint32_t count;
+    uint32_t capacity;
+    // this is for searching (if you'll need) when creating stack you can pass NULL
+    Stack_cmp cmp_template;
+    StackSlot *slots; // slots[count - 1] is the top
+} Stack;
 
 // create a stack
-#define Stack_create(cmp_callback) DLinked_create(cmp_callback)
+Stack *Stack_create(Stack_cmp cmp_callback);
 // push void *data in stack
-#define Stack_push(stack, data) DLinked_push(stack, data)
-// pop data from stack and return
-#define Stack_pop(stack) DLinked_pop(stack)
+int Stack_push(Stack *stack, void *data);
+// pop data from stack and return, NULL if stack is empty
+void *Stack_pop(Stack *stack);
+// return data on top without popping it, NULL if stack is empty
+void *Stack_peek(Stack *stack);
+// push count elements of data, data[count - 1] ends up on top
+int Stack_push_many(Stack *stack, void **data, uint32_t count);
+// pop up to count elements into out ( top first ) and return how many got popped
+int Stack_pop_many(Stack *stack, void **out, uint32_t count);
+// make room for at least capacity elements
+int Stack_reserve(Stack *stack, uint32_t capacity);
+
+// free stack but not data it contains, always pass a reference to make it NULL after freeing
+int Stack_destroy(Stack **stack);
 // if data structure, which nodes contain is complex (for example struct containing pointers)
 // use this function which iterates through list and applies your handler_func to all of it's *data fields
-#define Stack_free_complex_data(stack, handler_func) DLinked_free_complex_data(stack, handler_func)
+int Stack_free_complex_data(Stack **stack, free_func handler_func);
+
+// get how many elements stack has
+#define Stack_get_count(stack) (stack)->count
 
-// iterate through stack
+// iterate through stack from top to bottom
 // stack is Stack *, cur is current node's name you specify
-#define Stack_iter(stack, cur) DLinked_iter(stack, last, prev, cur)
+#define Stack_iter(stack, cur) StackSlot *cur = NULL; int64_t _slot = 0;\
+        for (_slot = (int64_t) (stack)->count - 1; _slot >= 0 && (cur = &(stack)->slots[_slot]); _slot--)
 // print stack contents
 // stack is Stack *, _data is a function returning printable data like ( int, char *, char, float ) ...
 // format is "%s" "%d" ... according to what data returns
-#define Stack_print(stack, _data, format) DLinked_print(stack, last, prev, _data, format)
+#define Stack_print(stack, _data, format) if (stack) {\
+            printf("\n[ ");\
+            Stack_iter (stack, cur) { printf((format " -> "), _data(cur->data)); }\
+            printf("NULL ]\n");\
+        } else {\
+            log_err("Somehow got stack that is NULL.");\
+        }
 // stack is Stack *
 // cmp_fucn is a function pointer which compares search data and every node's data
 // to find is the data you are looking for and found node is the variable name you want found data to be in
-#define Stack_search(stack, cmp_func, to_find, found_node) DLinked_search(stack, last, prev, cmp_func, to_find, found_node)
+#define Stack_search(stack, cmp_func, to_find, found_node) StackSlot *found_node = NULL;\
+        if (stack) {\
+            Stack_iter (stack, cur) {\
+                if (cmp_func(to_find, cur->data) == 0) {\
+                    found_node = cur;\
+                    break;\
+                }\
+            }\
+        } else {\
+            log_err("Somehow got stack that is NULL.");\
+        }
 
-#endif /* DA30B4E4_4771_452B_ABA5_8E814ED70200 */
\ No newline at end of file
+#endif /* DA30B4E4_4771_452B_ABA5_8E814ED70200 */
@@ -0,0 +1,404 @@
+#include "unrolled_list.h"
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(UListNode) == 128, "UListNode should be two cache lines.");
+
+/* nodes */
+
+static UListNode *UListNode_create(void)
+{
+    UListNode *node = aligned_alloc(64, sizeof(UListNode));
+    check_mem(node);
+
+    node->next = NULL;
+    node->prev = NULL;
+    node->count = 0;
+
+    return node;
+
+error:
+    return NULL;
+}
+
+// link node after prev, NULL prev means at the front
+static void UList_link_node(UList *list, UListNode *prev, UListNode *node)
+{
+    node->prev = prev;
+    node->next = prev ? prev->next : list->first;
+
+    if (node->next) {
+        node->next->prev = node;
+    } else {
+        list->last = node;
+    }
+
+    if (prev) {
+        prev->next = node;
+    } else {
+        list->first = node;
+    }
+
+    list->node_count++;
+}
+
+static void UList_free_node(UList *list, UListNode *node)
+{
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        list->first = node->next;
+    }
+
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        list->last = node->prev;
+    }
+
+    list->node_count--;
+    free(node);
+}
+
+/* create operations */
+
+UList *UList_create(void)
+{
+    UList *list = calloc(1, sizeof(UList));
+    check_mem(list);
+
+    return list;
+
+error:
+    return NULL;
+}
+
+/* both ends */
+
+int UList_push(UList *list, void *data)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    UListNode *node = list->last;
+    if (!node || node->count == ULIST_NODE_ITEMS) {
+        node = UListNode_create();
+        check(node != NULL, "Failed to create new node.");
+        UList_link_node(list, list->last, node);
+    }
+
+    node->items[node->count++].data = data;
+    list->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int UList_unshift(UList *list, void *data)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    UListNode *node = list->first;
+    if (!node || node->count == ULIST_NODE_ITEMS) {
+        node = UListNode_create();
+        check(node != NULL, "Failed to create new node.");
+        UList_link_node(list, NULL, node);
+    }
+
+    memmove(node->items + 1, node->items, sizeof(UListSlot) * node->count);
+    node->items[0].data = data;
+    node->count++;
+    list->count++;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *UList_pop(UList *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    UListNode *node = list->last;
+    if (!node) return NULL;
+
+    void *data = node->items[--node->count].data;
+    if (!node->count) UList_free_node(list, node);
+    list->count--;
+
+    return data;
+
+error:
+    return NULL;
+}
+
+void *UList_shift(UList *list)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+
+    UListNode *node = list->first;
+    if (!node) return NULL;
+
+    void *data = node->items[0].data;
+    memmove(node->items, node->items + 1, sizeof(UListSlot) * --node->count);
+    if (!node->count) UList_free_node(list, node);
+    list->count--;
+
+    return data;
+
+error:
+    return NULL;
+}
+
+/* middle of the list */
+
+UListIter UList_begin(UList *list)
+{
+    UListIter iter = { list ? list->first : NULL, 0 };
+    return iter;
+}
+
+int UList_insert(UList *list, UListIter *at, void *data)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(at != NULL, "Somehow got iterator that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    if (at->node == NULL) {
+        check(UList_push(list, data) != CERB_ERR, "Failed to insert at the end.");
+        at->node = list->last;
+        at->index = list->last->count - 1;
+        return CERB_OK;
+    }
+
+    check(at->index < at->node->count, "Invalid iterator.");
+    check(list->count < UINT32_MAX, "list has reached it's max length of %u AKA UINT32_MAX.", UINT32_MAX);
+
+    UListNode *node = at->node;
+    uint32_t index = at->index;
+
+    // full node gives its upper half to a new node after it, then data goes in whichever half index is in
+    if (node->count == ULIST_NODE_ITEMS) {
+        uint32_t half = ULIST_NODE_ITEMS / 2;
+
+        UListNode *new_node = UListNode_create();
+        check(new_node != NULL, "Failed to create new node.");
+        UList_link_node(list, node, new_node);
+
+        new_node->count = node->count - half;
+        memcpy(new_node->items, node->items + half, sizeof(UListSlot) * new_node->count);
+        node->count = half;
+
+        if (index > half) {
+            node = new_node;
+            index -= half;
+        }
+    }
+
+    memmove(node->items + index + 1, node->items + index, sizeof(UListSlot) * (node->count - index));
+    node->items[index].data = data;
+    node->count++;
+    list->count++;
+
+    at->node = node;
+    at->index = index;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *UList_remove(UList *list, UListIter *at)
+{
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(at != NULL, "Somehow got iterator that is NULL.");
+    check(at->node != NULL && at->index < at->node->count, "Invalid iterator.");
+
+    UListNode *node = at->node;
+    uint32_t index = at->index;
+    void *data = node->items[index].data;
+
+    memmove(node->items + index, node->items + index + 1, sizeof(UListSlot) * (node->count - index - 1));
+    node->count--;
+    list->count--;
+
+    if (!node->count) {
+        at->node = node->next;
+        at->index = 0;
+        UList_free_node(list, node);
+        return data;
+    }
+
+    // keep nodes at least half full, a node which got too empty takes in the next one if it fits
+    UListNode *next = node->next;
+    if (next && node->count < ULIST_NODE_ITEMS / 2 && node->count + next->count <= ULIST_NODE_ITEMS) {
+        memcpy(node->items + node->count, next->items, sizeof(UListSlot) * next->count);
+        node->count += next->count;
+        UList_free_node(list, next);
+    }
+
+    if (index == node->count) {
+        at->node = node->next;
+        at->index = 0;
+    }
+
+    return data;
+
+error:
+    return NULL;
+}
+
+/* joining and splitting */
+
+int UList_join(UList **list1, UList **list2)
+{
+    check(list1 != NULL, "Somehow got an address of the list1 that is NULL.");
+    check(*list1 != NULL, "Somehow got list1 that is NULL.");
+    check(list2 != NULL, "Somehow got an address of the list2 that is NULL.");
+    check(*list2 != NULL, "Somehow got list2 that is NULL.");
+    check(*list1 != *list2, "Couldn't join list with itself.");
+    check((uint64_t) (*list1)->count + (*list2)->count <= UINT32_MAX,
+    "Couldn't join lists as length exceeds %u AKA UINT32_MAX.", UINT32_MAX);
+
+    UList *to = *list1, *from = *list2;
+
+    if (from->first) {
+        UListNode *seam = to->last;
+
+        if (seam) {
+            seam->next = from->first;
+            from->first->prev = seam;
+        } else {
+            to->first = from->first;
+        }
+        to->last = from->last;
+        to->count += from->count;
+        to->node_count += from->node_count;
+
+        // two nodes meeting at the seam become one if they fit
+        UListNode *next = seam ? seam->next : NULL;
+        if (next && seam->count + next->count <= ULIST_NODE_ITEMS) {
+            memcpy(seam->items + seam->count, next->items, sizeof(UListSlot) * next->count);
+            seam->count += next->count;
+            UList_free_node(to, next);
+        }
+    }
+
+    free(from);
+    *list2 = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+UList *UList_split(UList *list, UListIter at)
+{
+    UList *new_list = NULL;
+
+    check(list != NULL, "Somehow got list that is NULL.");
+    check(at.node == NULL || at.index < at.node->count, "Invalid iterator.");
+
+    new_list = UList_create();
+    check(new_list != NULL, "Couldn't create new list.");
+
+    if (at.node == NULL) return new_list;
+
+    UListNode *start = at.node;
+
+    // split starts inside a node, its tail goes to a node of its own
+    if (at.index > 0) {
+        start = UListNode_create();
+        check(start != NULL, "Failed to create new node.");
+        UList_link_node(list, at.node, start);
+
+        start->count = at.node->count - at.index;
+        memcpy(start->items, at.node->items + at.index, sizeof(UListSlot) * start->count);
+        at.node->count = at.index;
+    }
+
+    new_list->first = start;
+    new_list->last = list->last;
+
+    list->last = start->prev;
+    if (list->last) {
+        list->last->next = NULL;
+    } else {
+        list->first = NULL;
+    }
+    start->prev = NULL;
+
+    UListNode *node = start;
+    for (; node != NULL; node = node->next) {
+        new_list->count += node->count;
+        new_list->node_count++;
+    }
+    list->count -= new_list->count;
+    list->node_count -= new_list->node_count;
+
+    return new_list;
+
+error:
+    free(new_list);
+    return NULL;
+}
+
+/* destroy operations */
+
+static void UList_free_all(UList *list, free_func handler_func)
+{
+    UListNode *node = list->first;
+
+    while (node) {
+        UListNode *next = node->next;
+
+        if (handler_func) {
+            uint32_t i = 0;
+            for (i = 0; i < node->count; i++) {
+                handler_func(node->items[i].data);
+            }
+        }
+
+        free(node);
+        node = next;
+    }
+
+    free(list);
+}
+
+int UList_destroy(UList **list)
+{
+    check(list != NULL, "Somehow got an address of the list that is NULL.");
+    check(*list != NULL, "Somehow got list that is NULL.");
+
+    UList_free_all(*list, NULL);
+    *list = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+int UList_free_complex_data(UList **list, free_func handler_func)
+{
+    check(list != NULL, "Somehow got an address of the list that is NULL.");
+    check(*list != NULL, "Somehow got list that is NULL.");
+    check(handler_func != NULL, "Somehow got handler_func that is NULL.");
+
+    UList_free_all(*list, handler_func);
+    *list = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,121 @@
+#ifndef CFDDC8CE_2034_4281_ADF7_51917E71CB3C
+#define CFDDC8CE_2034_4281_ADF7_51917E71CB3C
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stdint.h>
+#include "dbg.h"
+
+typedef void (*free_func) (void *data);
+
+// elements per node, chosen so a node is exactly two cache lines ( 128 bytes )
+// next, prev and count ( padded ) take three pointers worth, so 13 on 64 bit and 29 on 32 bit
+#define ULIST_NODE_ITEMS (128 / sizeof(void *) - 3)
+
+// one element, iteration macros give you pointers to these so cur->data works like with list nodes
+typedef struct UListSlot {
+    void *data;
+} UListSlot;
+
+// nodes are never empty, elements are packed at the front of items
+typedef struct UListNode {
+    struct UListNode *next;
+    struct UListNode *prev;
+    uint32_t count;
+    UListSlot items[ULIST_NODE_ITEMS];
+} UListNode;
+
+// unrolled doubly linked list, every node holds up to ULIST_NODE_ITEMS elements
+// scanning touches one cache miss per node instead of one per element,
+// splicing in the middle only moves elements of one node
+typedef struct UList {
+    UListNode *first;
+    UListNode *last;
+    uint32_t count;
+    uint32_t node_count;
+} UList;
+
+// position of one element, node is NULL past the last element
+typedef struct UListIter {
+    UListNode *node;
+    uint32_t index;
+} UListIter;
+
+// create UList *list
+UList *UList_create(void);
+
+// push data at the end
+int UList_push(UList *list, void *data);
+// remove last element and return it, NULL if list is empty
+void *UList_pop(UList *list);
+// insert data at the front
+int UList_unshift(UList *list, void *data);
+// remove first element and return it, NULL if list is empty
+void *UList_shift(UList *list);
+
+// iterator at the first element ( past the end if list is empty )
+UListIter UList_begin(UList *list);
+// insert data before the element at ( at the end if at is past the end ), at then points at the new element
+int UList_insert(UList *list, UListIter *at, void *data);
+// remove the element at and return it, at then points at the element which followed it
+// other iterators into the same or the next node aren't valid anymore
+void *UList_remove(UList *list, UListIter *at);
+
+// move every element of list2 to the end of list1 and free list2, provide references to them
+int UList_join(UList **list1, UList **list2);
+// move elements from at to the end into a new list and return it
+UList *UList_split(UList *list, UListIter at);
+
+// free list but not data it contains, always pass a reference to make it NULL after freeing
+int UList_destroy(UList **list);
+// if data structure, which nodes contain is complex (for example struct containing pointers)
+// use this function which iterates through list and applies your handler_func to all of it's *data fields
+int UList_free_complex_data(UList **list, free_func handler_func);
+
+#define UList_get_count(list) (list)->count
+
+#define UList_iter_valid(I) ((I).node != NULL)
+#define UList_iter_data(I) ((I).node->items[(I).index].data)
+// move iterator I to the next element
+#define UList_next(I) do {\
+            if (++(I).index == (I).node->count) {\
+                (I).node = (I).node->next;\
+                (I).index = 0;\
+            }\
+        } while (0)
+
+// iterate through list from first to last
+// L is UList *list, C is current slot's name you want it to have
+// one flat loop ( not one per node ) so break leaves it like with other lists
+#define UList_iter(L, C) UListNode *_unode = (L)->first; uint32_t _uindex = 0; UListSlot *C = NULL;\
+        for (; _unode != NULL && (C = &_unode->items[_uindex]);\
+                ++_uindex == _unode->count ? (_unode = _unode->next, _uindex = 0) : 0)
+
+// list is UList *list
+// _data is a function pointer returning anything that matches format ( %s %d %u ) etc.
+// format is "%s", "%d" ...
+#define UList_print(list, _data, format) if (list) {\
+            printf("\n[ ");\
+            UList_iter (list, cur) { printf((format " -> "), _data(cur->data)); }\
+            printf("NULL ]\n");\
+        } else {\
+            log_err("Somehow got list that is NULL.");\
+        }
+
+// list is UList *list
+// cmp_fucn is a function pointer which compares search data and every node's data
+// to find is the data you are looking for and found node is the variable name you want found data to be in
+#define UList_search(list, cmp_func, to_find, found_node) UListSlot *found_node = NULL;\
+        if (list) {\
+            UList_iter (list, cur) {\
+                if (cmp_func(to_find, cur->data) == 0) {\
+                    found_node = cur;\
+                    break;\
+                }\
+            }\
+        } else {\
+            log_err("Somehow got list that is NULL.");\
+        }
+
+#endif /* CFDDC8CE_2034_4281_ADF7_51917E71CB3C */
@@ -0,0 +1,168 @@
+#include "ws_deque.h"
+#include <stdlib.h>
+#include <string.h>
+
+// memory orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models"
+
+static WSDequeRing *WSDequeRing_create(int64_t size)
+{
+    WSDequeRing *ring = malloc(sizeof(WSDequeRing) + sizeof(_Atomic(void *)) * (size_t) size);
+    check_mem(ring);
+
+    ring->size = size;
+    ring->retired = NULL;
+
+    return ring;
+
+error:
+    return NULL;
+}
+
+static inline void *slot_load(WSDequeRing *ring, int64_t i)
+{
+    return atomic_load_explicit(&ring->slots[i & (ring->size - 1)], memory_order_relaxed);
+}
+
+static inline void slot_store(WSDequeRing *ring, int64_t i, void *data)
+{
+    atomic_store_explicit(&ring->slots[i & (ring->size - 1)], data, memory_order_relaxed);
+}
+
+WSDeque *WSDeque_create(void)
+{
+    WSDeque *deque = aligned_alloc(64, sizeof(WSDeque));
+    check_mem(deque);
+    memset(deque, 0, sizeof(WSDeque));
+
+    WSDequeRing *ring = WSDequeRing_create(WSDEQUE_INITIAL_CAPACITY);
+    check(ring != NULL, "Couldn't create ring.");
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->ring, ring);
+
+    return deque;
+
+error:
+    if (deque) free(deque);
+    return NULL;
+}
+
+// owner only, the old ring stays readable for thieves which loaded it before the swap
+static WSDequeRing *WSDeque_grow(WSDeque *deque, WSDequeRing *ring, int64_t top, int64_t bottom)
+{
+    WSDequeRing *bigger = WSDequeRing_create(ring->size * 2);
+    check(bigger != NULL, "Couldn't grow deque.");
+
+    int64_t i = 0;
+    for (i = top; i < bottom; i++) {
+        slot_store(bigger, i, slot_load(ring, i));
+    }
+    bigger->retired = ring;
+
+    atomic_store_explicit(&deque->ring, bigger, memory_order_release);
+
+    return bigger;
+
+error:
+    return NULL;
+}
+
+int WSDeque_push(WSDeque *deque, void *data)
+{
+    check(deque != NULL, "Somehow got deque that is NULL.");
+    check(data != NULL, "Somehow got data that is NULL.");
+
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    WSDequeRing *ring = atomic_load_explicit(&deque->ring, memory_order_relaxed);
+
+    if (bottom - top > ring->size - 1) {
+        ring = WSDeque_grow(deque, ring, top, bottom);
+        check(ring != NULL, "Couldn't push, deque is full.");
+    }
+
+    slot_store(ring, bottom, data);
+    // release store instead of the paper's release fence and relaxed store, same code on x86 and clearer to tools
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *WSDeque_pop(WSDeque *deque)
+{
+    check(deque != NULL, "Somehow got deque that is NULL.");
+
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    WSDequeRing *ring = atomic_load_explicit(&deque->ring, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    void *data = NULL;
+    if (top <= bottom) {
+        data = slot_load(ring, bottom);
+        if (top == bottom) {
+            // last element, thieves may be after it too
+            if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                        memory_order_seq_cst, memory_order_relaxed)) {
+                data = NULL;
+            }
+            atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        }
+    } else {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+
+    return data;
+
+error:
+    return NULL;
+}
+
+void *WSDeque_steal(WSDeque *deque)
+{
+    check(deque != NULL, "Somehow got deque that is NULL.");
+
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (top >= bottom) return NULL;
+
+    // acquire pairs with the release in grow, so a fresh ring's slots are visible
+    WSDequeRing *ring = atomic_load_explicit(&deque->ring, memory_order_acquire);
+    void *data = slot_load(ring, top);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+
+    return data;
+
+error:
+    return NULL;
+}
+
+int WSDeque_destroy(WSDeque **deque)
+{
+    check(deque != NULL, "Somehow got reference to deque that is NULL.");
+    check(*deque != NULL, "Somehow got deque that is NULL.");
+
+    WSDequeRing *ring = atomic_load_explicit(&(*deque)->ring, memory_order_relaxed);
+    while (ring) {
+        WSDequeRing *retired = ring->retired;
+        free(ring);
+        ring = retired;
+    }
+    free(*deque);
+    *deque = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,47 @@
+#ifndef CB545796_41C1_4D7C_B25C_17A8A3F8B687
+#define CB545796_41C1_4D7C_B25C_17A8A3F8B687
+
+#define CERB_OK 0
+#define CERB_ERR -1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dbg.h"
+
+// capacity of a new deque's ring ( it doubles whenever the owner fills it )
+#define WSDEQUE_INITIAL_CAPACITY 64
+
+// ring of slots, replaced ones are kept until the deque is destroyed because thieves may still read them
+typedef struct WSDequeRing {
+    int64_t size;
+    struct WSDequeRing *retired;
+    _Atomic(void *) slots[];
+} WSDequeRing;
+
+// Chase-Lev work stealing deque: one owner thread pushes and pops at the bottom ( newest first ),
+// any other thread steals from the top ( oldest first ), only the last element is ever fought over
+typedef struct WSDeque {
+    _Alignas(64) _Atomic int64_t top; // thieves move it up
+    _Alignas(64) _Atomic int64_t bottom; // only the owner moves it
+    _Atomic(WSDequeRing *) ring;
+} WSDeque;
+
+// create an empty deque
+WSDeque *WSDeque_create(void);
+// owner: push data at the bottom
+int WSDeque_push(WSDeque *deque, void *data);
+// owner: pop the newest element, NULL if the deque is empty
+void *WSDeque_pop(WSDeque *deque);
+// thief: take the oldest element, NULL if the deque is empty or another thread took it first
+void *WSDeque_steal(WSDeque *deque);
+
+// free the deque ( THIS DOES NOT FREE THE DATA IN IT ), nobody should be using it anymore
+// pass a reference to make it NULL after freeing
+int WSDeque_destroy(WSDeque **deque);
+
+// elements in the deque right now ( only a hint while others steal )
+#define WSDeque_length(D) (atomic_load_explicit(&(D)->bottom, memory_order_relaxed)\
+        - atomic_load_explicit(&(D)->top, memory_order_relaxed))
+
+#endif /* CB545796_41C1_4D7C_B25C_17A8A3F8B687 */
@@ -6,7 +6,26 @@
 #include "hashmap.h"
 #include "stack.h"
 #include "queue.h"
+#include "seg_array.h"
+#include "mapped_darray.h"
+#include "cow_darray.h"
+#include "DArray_parallel.h"
+#include "DArray_setops.h"
+#include "packed_array.h"
+#include "column_store.h"
+#include "pqueue.h"
+#include "mpmc_queue.h"
+#include "spsc_queue.h"
+#include "ws_deque.h"
+#include "scheduler.h"
+#include "lf_stack.h"
+#include "node_pool.h"
+#include "intrusive_list.h"
+#include "unrolled_list.h"
+#include "skip_list.h"
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 
 // static int length;
 
@@ -118,6 +137,79 @@ char *test_remove_SL()
     return NULL;
 }
 
+char *test_tail_SL()
+{
+    void *batch[3] = { test3, test4, test5 };
+
+    rc = SLinked_push(S_linked, test1);
+    mu_assert(rc != CERB_ERR && S_linked->first == S_linked->last, "push to empty list didn't set last.");
+    rc = SLinked_push_many(S_linked, batch, 3);
+    mu_assert(rc != CERB_ERR && S_linked->count == 4 && S_linked->last->data == test5, "push_many failed.");
+    rc = SLinked_insert_after(S_linked, S_linked->last, test2);
+    mu_assert(rc != CERB_ERR && S_linked->last->data == test2, "insert_after last didn't move last.");
+
+    SLinked *other = SLinked_create(NULL);
+    SLinked_push(other, test1);
+    rc = SLinked_join(&S_linked, &other);
+    mu_assert(rc != CERB_ERR && S_linked->count == 6 && S_linked->last->data == test1, "join failed.");
+
+    other = SLinked_split(&S_linked, S_linked->first->next->next, NULL);
+    mu_assert(other != NULL && other->count == 4 && other->last->data == test1, "split failed.");
+    mu_assert(S_linked->last == S_linked->first->next && S_linked->last->next == NULL, "split left wrong last.");
+    mu_assert(SLinked_pop(other) == test1 && other->last->data == test2, "pop didn't move last.");
+    SLinked_free_list(&other);
+
+    SLinked_reverse(S_linked);
+    mu_assert(S_linked->first->data == test3 && S_linked->last->data == test1, "reverse didn't swap ends.");
+    SLinked_shift(S_linked);
+    SLinked_shift(S_linked);
+    mu_assert(S_linked->first == NULL && S_linked->last == NULL, "emptied list kept last.");
+
+    return NULL;
+}
+
+typedef struct Keyed {
+    int key;
+    int seq;
+} Keyed;
+
+int cmp_keyed(const void *data1, const void *data2)
+{
+    return ((const Keyed *) data1)->key - ((const Keyed *) data2)->key;
+}
+
+Keyed keyed[200];
+
+char *test_sort_SL()
+{
+    SLinked *list = SLinked_create(cmp_keyed);
+    SLinked *other = SLinked_create(cmp_keyed);
+
+    int i = 0;
+    for (i = 0; i < 200; i++) {
+        keyed[i].key = (i * 37) % 23;
+        keyed[i].seq = i;
+        SLinked_push(i < 150 ? list : other, &keyed[i]);
+    }
+
+    rc = SLinked_sort(list);
+    mu_assert(rc != CERB_ERR && SLinked_sort(other) != CERB_ERR, "sort failed.");
+    rc = SLinked_merge_sorted(&list, &other);
+    mu_assert(rc != CERB_ERR && other == NULL && list->count == 200, "merge_sorted failed.");
+
+    Keyed *prev = NULL;
+    SLinked_iter (list, cur) {
+        Keyed *k = cur->data;
+        mu_assert(!prev || prev->key < k->key || (prev->key == k->key && prev->seq < k->seq), "list isn't sorted stably.");
+        prev = k;
+    }
+    mu_assert(list->last->data == prev && list->last->next == NULL, "sort left wrong last.");
+
+    SLinked_destroy(&list);
+
+    return NULL;
+}
+
 char *test_free_list_SL()
 {
     rc = SLinked_free_list(&S_linked);
@@ -169,6 +261,61 @@ char *test_remove_DL()
     return NULL;
 }
 
+char *test_splice_DL()
+{
+    DLinked_push(D_linked, test1);
+    DLinked_push(D_linked, test3);
+    DLinked_push(D_linked, test5);
+    DLinkedNode *middle = D_linked->first->next;
+
+    rc = DLinked_insert_after(D_linked, middle, test4);
+    mu_assert(rc != CERB_ERR && middle->next->data == test4, "insert_after failed.");
+    rc = DLinked_insert_before(D_linked, middle, test2);
+    mu_assert(rc != CERB_ERR && middle->prev->data == test2 && D_linked->count == 5, "insert_before failed.");
+
+    // a node whose neighbours don't point back at it isn't in the list
+    DLinkedNode stray = { .next = middle, .prev = D_linked->first, .data = test1 };
+    mu_assert(DLinked_remove(D_linked, &stray) == NULL && D_linked->count == 5, "removed a node from outside the list.");
+
+    mu_assert(DLinked_remove(D_linked, middle) == test3 && D_linked->count == 4, "remove failed.");
+    mu_assert(DLinked_remove_after(D_linked, D_linked->first) == test2, "remove_after failed.");
+    mu_assert(DLinked_remove_before(D_linked, D_linked->last) == test4, "remove_before failed.");
+    DLinked_shift(D_linked);
+    DLinked_shift(D_linked);
+
+    return NULL;
+}
+
+char *test_sort_DL()
+{
+    DLinked *list = DLinked_create(cmp_keyed);
+    DLinked *other = DLinked_create(cmp_keyed);
+
+    int i = 0;
+    for (i = 0; i < 200; i++) {
+        DLinked_push(i % 3 ? list : other, &keyed[i]);
+    }
+
+    rc = DLinked_sort(list);
+    mu_assert(rc != CERB_ERR && DLinked_sort(other) != CERB_ERR, "sort failed.");
+    rc = DLinked_merge_sorted(&list, &other);
+    mu_assert(rc != CERB_ERR && other == NULL && list->count == 200, "merge_sorted failed.");
+
+    int count = 0;
+    Keyed *prev = NULL;
+    DLinked_iter (list, last, prev, cur) {
+        Keyed *k = cur->data;
+        mu_assert(!prev || prev->key >= k->key, "list isn't sorted backwards.");
+        prev = k;
+        count++;
+    }
+    mu_assert(count == 200 && list->first->data == prev, "prev links are broken.");
+
+    DLinked_destroy(&list);
+
+    return NULL;
+}
+
 char *test_free_list_DL()
 {
     rc = DLinked_free_list(&D_linked);
@@ -233,6 +380,318 @@ char *test_pop_DA()
     return NULL;
 }
 
+char *test_search_index_DA()
+{
+    DArray *sorted = DArray_create(8, 5, NULL);
+    mu_assert(sorted != NULL, "failed to create array.");
+
+    // test1 .. test5 are already in sorted order
+    DArray_push(sorted, test1);
+    DArray_push(sorted, test2);
+    DArray_push(sorted, test2);
+    DArray_push(sorted, test4);
+    DArray_push(sorted, test5);
+
+    DArraySearchIndex *index = DArray_build_search_index(sorted);
+    mu_assert(index != NULL, "failed to build search index.");
+
+    int from = 0, to = 0;
+    mu_assert(DArraySearchIndex_lower_bound(index, test1) == 0, "wrong lower_bound.");
+    mu_assert(DArraySearchIndex_upper_bound(index, test5) == 5, "wrong upper_bound.");
+    mu_assert(DArraySearchIndex_lower_bound(index, test3) == 3, "wrong lower_bound for missing element.");
+    mu_assert(DArraySearchIndex_equal_range(index, test2, &from, &to) == 2, "wrong equal_range count.");
+    mu_assert(from == 1 && to == 3, "wrong equal_range.");
+    mu_assert(DArraySearchIndex_find(index, test4) == test4, "find failed.");
+    mu_assert(DArraySearchIndex_find(index, test3) == NULL, "found element which isn't there.");
+
+    rc = DArraySearchIndex_destroy(&index);
+    mu_assert(rc != CERB_ERR && index == NULL, "failed to destroy search index.");
+    DArray_free_array(&sorted);
+
+    return NULL;
+}
+
+char *test_scan_DA()
+{
+    DArray *ints = DArray_create(8, 40, NULL);
+    mu_assert(ints != NULL, "failed to create array.");
+
+    intptr_t i = 0, out = 0;
+    for (i = 1; i <= 37; i++) {
+        DArray_push(ints, (void *) (i % 5 - 2 ? i % 5 - 2 : 7));
+    }
+
+    mu_assert(DArray_get_pos(ints, ints->contents[20]) == 0, "wrong get_pos.");
+    mu_assert(DArray_find_int(ints, 7) == 1, "wrong find.");
+    mu_assert(DArray_find_int(ints, 100) == CERB_ERR, "found element which isn't there.");
+    mu_assert(DArray_count_int(ints, 2) == 7, "wrong count.");
+    mu_assert(DArray_min_int(ints, &out) == CERB_OK && out == -2, "wrong min.");
+    mu_assert(DArray_max_int(ints, &out) == CERB_OK && out == 7, "wrong max.");
+
+    DArray_free_array(&ints);
+
+    return NULL;
+}
+
+char *test_range_DA()
+{
+    DArray *ints = DArray_create(8, 2, NULL);
+    mu_assert(ints != NULL, "failed to create array.");
+
+    void *first[] = { (void *) 1, (void *) 2, (void *) 5, (void *) 6 };
+    void *middle[] = { (void *) 3, (void *) 4 };
+    void *removed[2] = { NULL, NULL };
+
+    rc = DArray_insert_range(ints, 0, first, 4);
+    mu_assert(rc != CERB_ERR && ints->length == 4, "insert_range failed.");
+    rc = DArray_insert_range(ints, 2, middle, 2);
+    mu_assert(rc != CERB_ERR && ints->length == 6, "insert_range failed.");
+    mu_assert(DArray_get(ints, 2) == (void *) 3 && DArray_get(ints, 5) == (void *) 6, "insert_range misplaced elements.");
+
+    rc = DArray_remove_range(ints, 1, 3, removed);
+    mu_assert(rc != CERB_ERR && ints->length == 4, "remove_range failed.");
+    mu_assert(removed[0] == (void *) 2 && removed[1] == (void *) 3, "remove_range returned wrong elements.");
+    mu_assert(DArray_get(ints, 1) == (void *) 4, "remove_range didn't close the gap.");
+
+    DArray_remove(ints, 0);
+    DArray_remove(ints, 2);
+    rc = DArray_compact(ints);
+    mu_assert(rc != CERB_ERR && ints->length == 2, "compact failed.");
+    mu_assert(DArray_get(ints, 0) == (void *) 4 && DArray_get(ints, 1) == (void *) 6, "compact misplaced elements.");
+
+    mu_assert(DArray_swap_remove(ints, 0) == (void *) 4, "swap_remove returned wrong element.");
+    mu_assert(ints->length == 1 && DArray_get(ints, 0) == (void *) 6, "swap_remove failed.");
+
+    DArray_free_array(&ints);
+
+    return NULL;
+}
+
+char *test_small_DA()
+{
+    DArray_small(4) tags;
+    rc = DArray_small_init(&tags, NULL);
+    mu_assert(rc != CERB_ERR && tags.array.capacity == 4, "failed to init small array.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 4; i++) {
+        DArray_push(&tags.array, (void *) i);
+    }
+    mu_assert(tags.array.contents == tags.storage, "small array left inline storage too early.");
+
+    DArray_push(&tags.array, (void *) 5);
+    mu_assert(tags.array.contents != tags.storage, "small array didn't spill to the heap.");
+    mu_assert(tags.array.length == 5 && DArray_get(&tags.array, 4) == (void *) 5, "wrong elements after spill.");
+    mu_assert(DArray_get(&tags.array, 0) == (void *) 1, "spill lost inline elements.");
+
+    rc = DArray_release(&tags.array);
+    mu_assert(rc != CERB_ERR && tags.array.length == 0, "failed to release small array.");
+
+    DArray_small(8) few;
+    DArray_small_init(&few, NULL);
+    for (i = 1; i <= 5; i++) {
+        DArray_push(&few.array, (void *) i);
+    }
+    DArray *middle = &few.array;
+    DArray *part = DArray_split(&middle, 1, 3);
+    mu_assert(part != NULL && part->length == 2 && DArray_get(part, 1) == (void *) 3, "split of small array failed.");
+    mu_assert(few.array.length == 3 && DArray_get(&few.array, 2) == (void *) 5, "small array kept wrong length after split.");
+    DArray_free_array(&part);
+    DArray_release(&few.array);
+
+    DArray_small(8) left;
+    DArray_small(4) right;
+    DArray_small_init(&left, NULL);
+    DArray_small_init(&right, NULL);
+    DArray_push(&left.array, test1);
+    DArray_push(&left.array, test2);
+    DArray_push(&right.array, test3);
+    DArray *joined = &left.array, *joining = &right.array;
+    rc = DArray_join(&joined, &joining);
+    mu_assert(rc != CERB_ERR && joining == NULL && left.array.length == 3, "joining small arrays got wrong length.");
+    mu_assert(DArray_get(&left.array, 0) == test1 && DArray_get(&left.array, 2) == test3, "joining small arrays lost elements.");
+    DArray_release(&left.array);
+
+    DArray *full = DArray_create(8, 2, NULL);
+    DArray *more = DArray_create(8, 2, NULL);
+    DArray_push(full, test1);
+    DArray_push(full, test2);
+    DArray_push(more, test3);
+    rc = DArray_join(&full, &more);
+    mu_assert(rc != CERB_ERR && full->length == 3 && DArray_get(full, 2) == test3, "joining past capacity failed.");
+    DArray_free_array(&full);
+
+    DArray *whole = DArray_create(8, 4, NULL);
+    for (i = 1; i <= 4; i++) {
+        DArray_push(whole, (void *) i);
+    }
+    part = DArray_split(&whole, 0, 4);
+    mu_assert(part != NULL && part->length == 4 && whole->length == 0, "splitting whole array failed.");
+    DArray_push(whole, (void *) 9);
+    mu_assert(DArray_get(whole, 0) == (void *) 9, "emptied array isn't usable.");
+    DArray_free_array(&part);
+    DArray_free_array(&whole);
+
+    return NULL;
+}
+
+char *test_huge_DA()
+{
+    DArray *big = DArray_create(8, 16, NULL);
+    mu_assert(big != NULL, "failed to create array.");
+
+    DArray_push(big, test1);
+    rc = DArray_set_huge_threshold(big, 4096);
+    mu_assert(rc != CERB_ERR && !(big->flags & DARRAY_HUGE_CONTENTS), "small contents went to huge pages.");
+
+    void *many[1024] = { NULL };
+    int i = 0;
+    for (i = 0; i < 1024; i++) many[i] = test2;
+    rc = DArray_insert_range(big, 1, many, 1024);
+    mu_assert(rc != CERB_ERR && (big->flags & DARRAY_HUGE_CONTENTS), "big contents didn't go to huge pages.");
+    mu_assert(((uintptr_t) big->contents & (2 * 1024 * 1024 - 1)) == 0, "huge contents aren't 2 MB aligned.");
+    mu_assert(DArray_get(big, 0) == test1 && DArray_get(big, 1024) == test2, "elements got lost moving to huge pages.");
+
+    rc = DArray_set_huge_threshold(big, 0);
+    mu_assert(rc != CERB_ERR && !(big->flags & DARRAY_HUGE_CONTENTS), "contents didn't leave huge pages.");
+    mu_assert(DArray_get(big, 0) == test1 && DArray_get(big, 1024) == test2, "elements got lost leaving huge pages.");
+
+    DArray_free_array(&big);
+
+    DArray *empty = DArray_create(8, 0, NULL);
+    mu_assert(empty != NULL, "failed to create empty array.");
+    rc = DArray_set_huge_threshold(empty, 4096);
+    mu_assert(rc != CERB_ERR && empty->contents != NULL, "threshold on empty array lost contents.");
+    rc = DArray_destroy(&empty);
+    mu_assert(rc != CERB_ERR && empty == NULL, "failed to destroy empty array.");
+
+    return NULL;
+}
+
+void double_element(void *element, int i, void *ctx)
+{
+    ((DArray *) ctx)->contents[i] = (void *) ((intptr_t) element * 2);
+}
+
+void *sum_elements(void *accumulator, void *element, void *ctx)
+{
+    (void) ctx;
+    return (void *) ((intptr_t) accumulator + (intptr_t) element);
+}
+
+int keep_multiple_of_3(void *element, void *ctx)
+{
+    (void) ctx;
+    return (intptr_t) element % 3 == 0;
+}
+
+void resize_pool_inside(void *element, int i, void *ctx)
+{
+    (void) element;
+    if (i == 0) *(int *) ctx = DArray_parallel_set_threads(2);
+}
+
+char *test_parallel_DA()
+{
+    DArray *ints = DArray_create(8, 100000, NULL);
+    mu_assert(ints != NULL, "failed to create array.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 100000; i++) {
+        DArray_push(ints, (void *) i);
+    }
+
+    rc = DArray_parallel_for(ints, double_element, ints);
+    mu_assert(rc != CERB_ERR && DArray_get(ints, 99999) == (void *) 200000, "parallel_for failed.");
+
+    intptr_t sum = (intptr_t) DArray_parallel_reduce(ints, (void *) 0, sum_elements, sum_elements, NULL);
+    mu_assert(sum == (intptr_t) 100000 * 100001, "parallel_reduce failed.");
+
+    DArray *kept = DArray_parallel_filter(ints, keep_multiple_of_3, NULL);
+    mu_assert(kept != NULL && kept->length == 33333, "parallel_filter kept wrong elements.");
+    for (i = 0; i < kept->length; i++) {
+        mu_assert(DArray_get(kept, (int) i) == (void *) ((i + 1) * 6), "parallel_filter lost order.");
+    }
+
+    // changing the pool from a callback would wait for the call it's part of
+    int inside = CERB_OK;
+    ints->length = 64;
+    rc = DArray_parallel_for(ints, resize_pool_inside, &inside);
+    mu_assert(rc != CERB_ERR && inside == CERB_ERR, "set_threads ran from inside a parallel call.");
+
+    DArray_free_array(&kept);
+    DArray_free_array(&ints);
+    DArray_parallel_shutdown();
+
+    return NULL;
+}
+
+int cmp_intptr(const void *data1, const void *data2)
+{
+    intptr_t a = (intptr_t) data1, b = (intptr_t) data2;
+    return (a > b) - (a < b);
+}
+
+char *test_setops_DA()
+{
+    DArray *evens = DArray_create(8, 1000, cmp_intptr);
+    DArray *threes = DArray_create(8, 400, cmp_intptr);
+    DArray *few = DArray_create(8, 4, cmp_intptr);
+    mu_assert(evens != NULL && threes != NULL && few != NULL, "failed to create arrays.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 1000; i++) DArray_push(evens, (void *) (i * 2));
+    for (i = 1; i <= 400; i++) DArray_push(threes, (void *) (i * 3));
+    DArray_push(few, (void *) 7);
+    DArray_push(few, (void *) 500);
+    DArray_push(few, (void *) 1998);
+
+    // plain merges
+    DArray *both = DArray_sorted_intersect(evens, threes);
+    mu_assert(both != NULL && both->length == 200 && DArray_get(both, 199) == (void *) 1200, "intersect failed.");
+    DArray *either = DArray_sorted_union(evens, threes);
+    mu_assert(either != NULL && either->length == 1200, "union failed.");
+    DArray *only = DArray_sorted_difference(evens, threes);
+    mu_assert(only != NULL && only->length == 800, "difference failed.");
+    for (i = 1; i < either->length; i++) {
+        mu_assert(DArray_get(either, (int) i - 1) < DArray_get(either, (int) i), "union isn't sorted.");
+    }
+
+    // galloping merges
+    DArray *few_both = DArray_sorted_intersect(few, evens);
+    mu_assert(few_both != NULL && few_both->length == 2 && DArray_get(few_both, 1) == (void *) 1998, "galloping intersect failed.");
+    DArray *few_either = DArray_sorted_union(evens, few);
+    mu_assert(few_either != NULL && few_either->length == 1001 && DArray_get(few_either, 3) == (void *) 7, "galloping union failed.");
+    DArray *without_few = DArray_sorted_difference(evens, few);
+    mu_assert(without_few != NULL && without_few->length == 998, "galloping difference failed.");
+
+    // inline integer versions have to agree with the generic ones
+    DArray *both_int = DArray_sorted_intersect_int(evens, threes);
+    DArray *either_int = DArray_sorted_union_int(evens, threes);
+    DArray *only_int = DArray_sorted_difference_int(evens, threes);
+    mu_assert(both_int != NULL && either_int != NULL && only_int != NULL, "int set operations failed.");
+    mu_assert(both_int->length == both->length && either_int->length == either->length && only_int->length == only->length,
+            "int set operations disagree on length.");
+    mu_assert(memcmp(both_int->contents, both->contents, sizeof(void *) * both->length) == 0, "int intersect disagrees.");
+    mu_assert(memcmp(either_int->contents, either->contents, sizeof(void *) * either->length) == 0, "int union disagrees.");
+    mu_assert(memcmp(only_int->contents, only->contents, sizeof(void *) * only->length) == 0, "int difference disagrees.");
+
+    DArray *parts[] = { threes, few, evens };
+    DArray *merged = DArray_sorted_merge_k(parts, 3);
+    mu_assert(merged != NULL && merged->length == 1403, "merge_k failed.");
+    for (i = 1; i < merged->length; i++) {
+        mu_assert(DArray_get(merged, (int) i - 1) <= DArray_get(merged, (int) i), "merge_k isn't sorted.");
+    }
+
+    DArray *results[] = { both, either, only, few_both, few_either, without_few, both_int, either_int, only_int, merged };
+    for (i = 0; i < 10; i++) DArray_free_array(&results[i]);
+    DArray_free_array(&evens);
+    DArray_free_array(&threes);
+    DArray_free_array(&few);
+
+    return NULL;
+}
+
 char *test_free_array_DA()
 {
     rc = DArray_free_array(&D_array);
@@ -241,6 +700,838 @@ char *test_free_array_DA()
     return NULL;
 }
 
+// test segmented array
+
+#define SEG_PUSHERS 4
+#define SEG_PUSHES 5000
+
+void *seg_pusher(void *array)
+{
+    intptr_t i = 0;
+    for (i = 1; i <= SEG_PUSHES; i++) {
+        if (SegArray_push(array, (void *) i, NULL) == CERB_ERR) return array;
+    }
+
+    return NULL;
+}
+
+char *test_concurrent_push_SA()
+{
+    SegArray *array = SegArray_create();
+    mu_assert(array != NULL, "failed to create array.");
+
+    pthread_t threads[SEG_PUSHERS];
+    int i = 0;
+    for (i = 0; i < SEG_PUSHERS; i++) {
+        mu_assert(pthread_create(&threads[i], NULL, seg_pusher, array) == 0, "failed to start pusher.");
+    }
+
+    void *failed = NULL;
+    for (i = 0; i < SEG_PUSHERS; i++) {
+        pthread_join(threads[i], &failed);
+        mu_assert(failed == NULL, "concurrent push failed.");
+    }
+    mu_assert(SegArray_length(array) == SEG_PUSHERS * SEG_PUSHES, "wrong length after concurrent push.");
+
+    // every pusher pushed 1 .. SEG_PUSHES once, so values have to add up
+    intptr_t sum = 0;
+    size_t j = 0;
+    for (j = 0; j < SegArray_length(array); j++) {
+        sum += (intptr_t) SegArray_get(array, j);
+    }
+    mu_assert(sum == (intptr_t) SEG_PUSHERS * SEG_PUSHES * (SEG_PUSHES + 1) / 2, "lost elements on concurrent push.");
+    mu_assert(SegArray_get(array, j) == NULL, "got element past the end.");
+
+    rc = SegArray_destroy(&array);
+    mu_assert(rc != CERB_ERR && array == NULL, "failed to destroy array.");
+
+    return NULL;
+}
+
+// test mapped array
+
+typedef struct Record {
+    int64_t id;
+    double value;
+} Record;
+
+char *test_persist_MA()
+{
+    const char *path = "tests/mapped_darray.bin";
+    MappedDArray *array = MappedDArray_create(path, sizeof(Record), 0, 0);
+    mu_assert(array != NULL, "failed to create array.");
+
+    Record record = { 0, 0.0 };
+    for (record.id = 0; record.id < 1000; record.id++) {
+        record.value = record.id * 0.5;
+        rc = MappedDArray_push(array, &record);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+    rc = MappedDArray_pop(array, &record);
+    mu_assert(rc != CERB_ERR && record.id == 999, "pop failed.");
+    mu_assert(MappedDArray_advise(array, MAPPED_DARRAY_SEQUENTIAL) != CERB_ERR, "advise failed.");
+
+    size_t capacity = array->capacity;
+    rc = MappedDArray_reserve(array, SIZE_MAX / 2);
+    mu_assert(rc == CERB_ERR && array->capacity == capacity, "reserve overflowed the file size.");
+
+    rc = MappedDArray_close(&array);
+    mu_assert(rc != CERB_ERR && array == NULL, "failed to close array.");
+
+    array = MappedDArray_open(path, MAPPED_DARRAY_POPULATE);
+    mu_assert(array != NULL, "failed to reopen array.");
+    mu_assert(MappedDArray_length(array) == 999, "wrong length after reopen.");
+
+    Record *stored = MappedDArray_get(array, 998);
+    mu_assert(stored != NULL && stored->id == 998 && stored->value == 499.0, "wrong record after reopen.");
+    mu_assert(MappedDArray_get(array, 999) == NULL, "got record past the end.");
+
+    MappedDArray_close(&array);
+    remove(path);
+
+    return NULL;
+}
+
+// test copy on write array
+
+char *test_snapshot_CA()
+{
+    CowDArray *array = CowDArray_create();
+    mu_assert(array != NULL, "failed to create array.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 200; i++) {
+        rc = CowDArray_push(array, (void *) i);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+
+    CowDArraySnapshot *before = CowDArray_snapshot(array);
+    mu_assert(CowDArraySnapshot_length(before) == 0, "snapshot saw unpublished changes.");
+    CowDArray_release(array, &before);
+
+    CowDArray_publish(array);
+    before = CowDArray_snapshot(array);
+    mu_assert(CowDArraySnapshot_length(before) == 200, "snapshot missed published changes.");
+
+    rc = CowDArray_set(array, 5, (void *) 1000);
+    mu_assert(rc != CERB_ERR, "set failed.");
+    mu_assert(CowDArray_pop(array) == (void *) 200, "pop failed.");
+    CowDArray_publish(array);
+
+    CowDArraySnapshot *after = CowDArray_snapshot(array);
+    mu_assert(CowDArraySnapshot_get(before, 5) == (void *) 6, "old snapshot changed after publish.");
+    mu_assert(CowDArraySnapshot_length(before) == 200, "old snapshot changed after publish.");
+    mu_assert(CowDArraySnapshot_get(after, 5) == (void *) 1000, "new snapshot missed set.");
+    mu_assert(CowDArraySnapshot_length(after) == 199, "new snapshot missed pop.");
+    // untouched chunks are shared between versions
+    mu_assert(before->chunks[1] == after->chunks[1], "untouched chunk got copied.");
+
+    CowDArray_release(array, &before);
+    CowDArray_release(array, &after);
+    mu_assert(before == NULL && after == NULL, "failed to release snapshots.");
+
+    // reader count is saturated rather than wrapped
+    CowDArraySnapshot **held = malloc(sizeof(CowDArraySnapshot *) * COW_DARRAY_MAX_SNAPSHOTS);
+    mu_assert(held != NULL, "failed to allocate snapshots.");
+    for (i = 0; i < COW_DARRAY_MAX_SNAPSHOTS; i++) {
+        held[i] = CowDArray_snapshot(array);
+        mu_assert(held[i] != NULL, "snapshot refused too early.");
+    }
+    mu_assert(CowDArray_snapshot(array) == NULL, "snapshot count overflowed.");
+    for (i = 0; i < COW_DARRAY_MAX_SNAPSHOTS; i++) {
+        CowDArray_release(array, &held[i]);
+    }
+    free(held);
+    after = CowDArray_snapshot(array);
+    mu_assert(after != NULL && CowDArraySnapshot_length(after) == 199, "version didn't survive full count.");
+    CowDArray_release(array, &after);
+
+    rc = CowDArray_destroy(&array);
+    mu_assert(rc != CERB_ERR && array == NULL, "failed to destroy array.");
+
+    return NULL;
+}
+
+// test packed array
+
+char *test_pack_PA()
+{
+    DArray *ids = DArray_create(8, 1000, NULL);
+    mu_assert(ids != NULL, "failed to create array.");
+
+    intptr_t i = 0, id = 1000000;
+    for (i = 0; i < 1000; i++) {
+        id += 1 + i % 7;
+        DArray_push(ids, (void *) id);
+    }
+
+    PackedArray *packed = PackedArray_from_DArray(ids, PACKED_ARRAY_INLINE);
+    mu_assert(packed != NULL && PackedArray_length(packed) == 1000, "failed to pack array.");
+    mu_assert(PackedArray_bytes(packed) < 1000 * sizeof(void *) / 8, "array didn't shrink.");
+
+    int64_t value = 0;
+    for (i = 0; i < 1000; i++) {
+        rc = PackedArray_get(packed, (int) i, &value);
+        mu_assert(rc != CERB_ERR && value == (intptr_t) DArray_get(ids, (int) i), "unpacked wrong value.");
+    }
+
+    mu_assert(PackedArray_find(packed, (intptr_t) DArray_get(ids, 700)) == 700, "find missed value.");
+    mu_assert(PackedArray_find(packed, (intptr_t) DArray_get(ids, 700) + 1) == -1, "find made up value.");
+    mu_assert(PackedArray_lower_bound(packed, 0) == 0, "lower_bound before first failed.");
+    mu_assert(PackedArray_lower_bound(packed, id + 1) == 1000, "lower_bound past last failed.");
+
+    rc = PackedArray_destroy(&packed);
+    mu_assert(rc != CERB_ERR && packed == NULL, "failed to destroy array.");
+    DArray_free_array(&ids);
+
+    return NULL;
+}
+
+// test column store
+
+typedef struct Event {
+    int64_t timestamp;
+    int32_t kind;
+    double value;
+} Event;
+
+char *test_columns_CS()
+{
+    ColumnField schema[] = { COLUMN_FIELD(Event, timestamp), COLUMN_FIELD(Event, kind), COLUMN_FIELD(Event, value) };
+    ColumnStore *events = ColumnStore_create(schema, 3, sizeof(Event), 2);
+    mu_assert(events != NULL, "failed to create store.");
+
+    int i = 0;
+    for (i = 0; i < 100; i++) {
+        Event event = { .timestamp = 1000 + i, .kind = i % 4, .value = i * 0.5 };
+        rc = ColumnStore_push(events, &event);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+    mu_assert(ColumnStore_length(events) == 100 && events->capacity >= 100, "store didn't grow.");
+
+    Event event = { 0, 0, 0 };
+    rc = ColumnStore_get(events, 42, &event);
+    mu_assert(rc != CERB_ERR && event.timestamp == 1042 && event.kind == 2 && event.value == 21.0, "get returned wrong row.");
+
+    event.kind = 7;
+    rc = ColumnStore_set(events, 42, &event);
+    mu_assert(rc != CERB_ERR, "set failed.");
+
+    int32_t *kinds = ColumnStore_column(events, 1);
+    mu_assert(kinds != NULL && ((uintptr_t) kinds % COLUMN_STORE_ALIGN) == 0, "column isn't aligned.");
+    int sevens = 0;
+    for (i = 0; i < ColumnStore_length(events); i++) sevens += kinds[i] == 7;
+    mu_assert(sevens == 1, "column scan missed set.");
+
+    rc = ColumnStore_pop(events, &event);
+    mu_assert(rc != CERB_ERR && event.timestamp == 1099 && ColumnStore_length(events) == 99, "pop failed.");
+
+    rc = ColumnStore_destroy(&events);
+    mu_assert(rc != CERB_ERR && events == NULL, "failed to destroy store.");
+
+    return NULL;
+}
+
+// test priority queue
+
+typedef struct Task {
+    int priority;
+} Task;
+
+int cmp_task(const void *data1, const void *data2)
+{
+    return ((const Task *) data1)->priority - ((const Task *) data2)->priority;
+}
+
+char *test_order_PQ()
+{
+    Task tasks[500];
+    PQueueNode *handles[500];
+    void *pointers[500];
+    int i = 0;
+    for (i = 0; i < 500; i++) {
+        tasks[i].priority = (i * 7919) % 1000;
+        pointers[i] = &tasks[i];
+    }
+
+    PQueue *queue = PQueue_create(PQUEUE_QUAD, cmp_task);
+    mu_assert(queue != NULL, "failed to create queue.");
+    rc = PQueue_push_many(queue, pointers, 500, handles);
+    mu_assert(rc != CERB_ERR && PQueue_length(queue) == 500, "push_many failed.");
+
+    tasks[123].priority = -1;
+    rc = PQueue_decrease_key(queue, handles[123]);
+    mu_assert(rc != CERB_ERR && PQueue_peek(queue) == &tasks[123], "decrease_key didn't move task to the top.");
+
+    int previous = -2;
+    while (PQueue_length(queue)) {
+        Task *task = PQueue_pop_min(queue);
+        mu_assert(task->priority >= previous, "queue popped out of order.");
+        previous = task->priority;
+    }
+    mu_assert(PQueue_pop_min(queue) == NULL, "empty queue popped something.");
+
+    mu_assert(PQueue_push(queue, &tasks[0]) != NULL && PQueue_peek(queue) == &tasks[0], "push after emptying failed.");
+    PQueue_destroy(&queue);
+
+    DArray *array = DArray_create(8, 500, cmp_task);
+    for (i = 0; i < 500; i++) DArray_push(array, pointers[i]);
+    queue = PQueue_heapify(array, PQUEUE_BINARY);
+    mu_assert(queue != NULL && PQueue_length(queue) == 500, "heapify failed.");
+    previous = -2;
+    while (PQueue_length(queue)) {
+        Task *task = PQueue_pop_min(queue);
+        mu_assert(task->priority >= previous, "heapified queue popped out of order.");
+        previous = task->priority;
+    }
+
+    // failing before anything got appended leaves an empty heap to rebuild
+    rc = PQueue_push_many(queue, NULL, 3, NULL);
+    mu_assert(rc == CERB_ERR && PQueue_length(queue) == 0, "push_many of NULL data went through.");
+    mu_assert(PQueue_push_many(NULL, pointers, 3, NULL) == CERB_ERR, "push_many into NULL queue went through.");
+
+    rc = PQueue_destroy(&queue);
+    mu_assert(rc != CERB_ERR && queue == NULL, "failed to destroy queue.");
+    DArray_free_array(&array);
+
+    return NULL;
+}
+
+// test stack
+
+char *test_push_pop_ST()
+{
+    stack = Stack_create(NULL);
+    mu_assert(stack != NULL, "failed to create stack.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 100; i++) {
+        rc = Stack_push(stack, (void *) i);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+    mu_assert(Stack_get_count(stack) == 100 && stack->capacity == 128, "stack didn't grow to a power of two.");
+    mu_assert(Stack_pop(stack) == (void *) 100 && Stack_peek(stack) == (void *) 99, "pop returned wrong element.");
+
+    intptr_t expected = 99;
+    Stack_iter (stack, cur) {
+        mu_assert(cur->data == (void *) expected--, "iter went in wrong order.");
+    }
+
+    void *batch[3] = { (void *) 1000, (void *) 1001, (void *) 1002 };
+    void *popped[5] = { NULL };
+    rc = Stack_push_many(stack, batch, 3);
+    mu_assert(rc != CERB_ERR && Stack_peek(stack) == (void *) 1002, "push_many failed.");
+    rc = Stack_pop_many(stack, popped, 5);
+    mu_assert(rc == 5 && popped[0] == (void *) 1002 && popped[4] == (void *) 98, "pop_many failed.");
+
+    rc = Stack_destroy(&stack);
+    mu_assert(rc != CERB_ERR && stack == NULL, "failed to destroy stack.");
+
+    return NULL;
+}
+
+// test queue
+
+char *test_ring_QU()
+{
+    queue = Queue_create();
+    mu_assert(queue != NULL, "failed to create queue.");
+
+    // move head around so elements wrap past the end of the ring
+    intptr_t i = 0;
+    for (i = 1; i <= 10; i++) Queue_unshift(queue, (void *) i);
+    for (i = 1; i <= 10; i++) mu_assert(Queue_pop(queue) == (void *) i, "pop returned wrong element.");
+
+    for (i = 1; i <= 40; i++) {
+        rc = Queue_unshift(queue, (void *) i);
+        mu_assert(rc != CERB_ERR, "unshift failed.");
+    }
+    mu_assert(Queue_get_count(queue) == 40 && queue->capacity == 64, "queue didn't grow to a power of two.");
+    mu_assert(Queue_peek(queue) == (void *) 1, "growing lost order.");
+
+    intptr_t expected = 40;
+    Queue_iter (queue, cur) {
+        mu_assert(cur->data == (void *) expected--, "iter went in wrong order.");
+    }
+
+    void *popped[30] = { NULL };
+    rc = Queue_pop_many(queue, popped, 30);
+    mu_assert(rc == 30 && popped[0] == (void *) 1 && popped[29] == (void *) 30, "pop_many failed.");
+    rc = Queue_unshift_many(queue, popped, 30);
+    mu_assert(rc != CERB_ERR && Queue_get_count(queue) == 40, "unshift_many failed.");
+    for (i = 31; i <= 40; i++) mu_assert(Queue_pop(queue) == (void *) i, "unshift_many broke order.");
+    mu_assert(Queue_pop(queue) == (void *) 1, "unshift_many broke order.");
+
+    rc = Queue_destroy(&queue);
+    mu_assert(rc != CERB_ERR && queue == NULL, "failed to destroy queue.");
+
+    return NULL;
+}
+
+// test lock free queue
+
+#define MPMC_THREADS 2
+#define MPMC_PUSHES 20000
+
+MPMCQueue *handoff = NULL;
+
+void *mpmc_producer(void *arg)
+{
+    (void) arg;
+    intptr_t i = 0;
+    for (i = 1; i <= MPMC_PUSHES; i++) {
+        while (MPMCQueue_try_push(handoff, (void *) i) == CERB_ERR) sched_yield();
+    }
+
+    return NULL;
+}
+
+void *mpmc_consumer(void *arg)
+{
+    intptr_t sum = 0;
+    void *element = NULL;
+    while ((element = MPMCQueue_pop_wait(handoff)) != NULL) {
+        sum += (intptr_t) element;
+    }
+    *(intptr_t *) arg = sum;
+
+    return NULL;
+}
+
+char *test_handoff_MQ()
+{
+    handoff = MPMCQueue_create(100);
+    mu_assert(handoff != NULL && handoff->mask == 127, "failed to create queue.");
+
+    void *batch[3] = { (void *) 1, (void *) 2, (void *) 3 };
+    void *popped[4] = { NULL };
+    mu_assert(MPMCQueue_try_push_many(handoff, batch, 3) == 3, "push_many failed.");
+    void *with_null[2] = { test1, NULL };
+    mu_assert(MPMCQueue_try_push_many(handoff, with_null, 2) == CERB_ERR, "push_many took a NULL element.");
+    mu_assert(MPMCQueue_try_pop_many(handoff, popped, 4) == 3 && popped[2] == (void *) 3, "pop_many failed.");
+    mu_assert(MPMCQueue_try_pop(handoff) == NULL, "empty queue popped something.");
+
+    MPMCQueue *tiny = MPMCQueue_create(2);
+    mu_assert(tiny != NULL && MPMCQueue_try_push_many(tiny, batch, 3) == 2, "tiny queue took wrong count.");
+    MPMCQueue_destroy(&tiny);
+
+    pthread_t producers[MPMC_THREADS], consumers[MPMC_THREADS];
+    intptr_t sums[MPMC_THREADS] = { 0 };
+    int i = 0;
+    for (i = 0; i < MPMC_THREADS; i++) {
+        mu_assert(pthread_create(&consumers[i], NULL, mpmc_consumer, &sums[i]) == 0, "failed to start consumer.");
+        mu_assert(pthread_create(&producers[i], NULL, mpmc_producer, NULL) == 0, "failed to start producer.");
+    }
+    for (i = 0; i < MPMC_THREADS; i++) pthread_join(producers[i], NULL);
+    MPMCQueue_close(handoff);
+    for (i = 0; i < MPMC_THREADS; i++) pthread_join(consumers[i], NULL);
+
+    intptr_t total = 0;
+    for (i = 0; i < MPMC_THREADS; i++) total += sums[i];
+    mu_assert(total == (intptr_t) MPMC_THREADS * MPMC_PUSHES * (MPMC_PUSHES + 1) / 2, "elements got lost or duplicated.");
+
+    rc = MPMCQueue_destroy(&handoff);
+    mu_assert(rc != CERB_ERR && handoff == NULL, "failed to destroy queue.");
+    mu_assert(MPMCQueue_destroy(&handoff) == CERB_ERR, "destroyed queue twice.");
+
+    return NULL;
+}
+
+// test single producer single consumer queue
+
+#define SPSC_PUSHES 50000
+
+void *spsc_producer(void *queue)
+{
+    intptr_t i = 1;
+    while (i <= SPSC_PUSHES) {
+        size_t granted = 0;
+        void **slots = SPSCQueue_reserve(queue, 16, &granted);
+        if (!slots) {
+            sched_yield();
+            continue;
+        }
+
+        size_t k = 0;
+        for (k = 0; k < granted && i <= SPSC_PUSHES; k++) slots[k] = (void *) i++;
+        SPSCQueue_commit(queue, k);
+    }
+
+    return NULL;
+}
+
+char *test_pipeline_SQ()
+{
+    SPSCQueue *queue = SPSCQueue_create(64);
+    mu_assert(queue != NULL && queue->mask == 63, "failed to create queue.");
+
+    mu_assert(SPSCQueue_try_pop(queue) == NULL, "empty queue popped something.");
+    mu_assert(SPSCQueue_try_push(queue, test1) == CERB_OK && SPSCQueue_length(queue) == 1, "push failed.");
+    mu_assert(SPSCQueue_try_push(queue, NULL) == CERB_ERR && SPSCQueue_length(queue) == 1, "pushed NULL.");
+    mu_assert(SPSCQueue_try_pop(queue) == test1, "pop returned wrong element.");
+
+    pthread_t producer;
+    mu_assert(pthread_create(&producer, NULL, spsc_producer, queue) == 0, "failed to start producer.");
+
+    intptr_t expected = 1;
+    while (expected <= SPSC_PUSHES) {
+        size_t available = 0;
+        void **slots = SPSCQueue_peek(queue, &available);
+        if (!slots) {
+            sched_yield();
+            continue;
+        }
+
+        size_t k = 0;
+        for (k = 0; k < available; k++) {
+            mu_assert(slots[k] == (void *) expected++, "elements came out of order.");
+        }
+        SPSCQueue_release(queue, available);
+    }
+    pthread_join(producer, NULL);
+
+    rc = SPSCQueue_destroy(&queue);
+    mu_assert(rc != CERB_ERR && queue == NULL, "failed to destroy queue.");
+    mu_assert(SPSCQueue_destroy(&queue) == CERB_ERR, "destroyed queue twice.");
+
+    return NULL;
+}
+
+// test work stealing deque and scheduler
+
+char *test_deque_WS()
+{
+    WSDeque *deque = WSDeque_create();
+    mu_assert(deque != NULL, "failed to create deque.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 100; i++) {
+        rc = WSDeque_push(deque, (void *) i);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+    mu_assert(WSDeque_length(deque) == 100, "deque didn't grow.");
+
+    mu_assert(WSDeque_pop(deque) == (void *) 100, "owner didn't get the newest element.");
+    mu_assert(WSDeque_steal(deque) == (void *) 1, "thief didn't get the oldest element.");
+    for (i = 99; i >= 2; i--) mu_assert(WSDeque_pop(deque) == (void *) i, "pop went in wrong order.");
+    mu_assert(WSDeque_pop(deque) == NULL && WSDeque_steal(deque) == NULL, "empty deque gave something.");
+
+    rc = WSDeque_destroy(&deque);
+    mu_assert(rc != CERB_ERR && deque == NULL, "failed to destroy deque.");
+    mu_assert(WSDeque_destroy(&deque) == CERB_ERR, "destroyed deque twice.");
+
+    return NULL;
+}
+
+typedef struct SumRange {
+    Scheduler *scheduler;
+    intptr_t from;
+    intptr_t to;
+    intptr_t sum;
+} SumRange;
+
+// split in halves until ranges are small, one half gets spawned and the other one done right here
+void sum_range(void *arg)
+{
+    SumRange *range = arg;
+    if (range->to - range->from <= 100) {
+        intptr_t i = 0;
+        for (i = range->from; i < range->to; i++) range->sum += i;
+        return;
+    }
+
+    intptr_t middle = range->from + (range->to - range->from) / 2;
+    SumRange left = { range->scheduler, range->from, middle, 0 };
+    SumRange right = { range->scheduler, middle, range->to, 0 };
+
+    TaskGroup group;
+    TaskGroup_init(&group);
+    Scheduler_spawn(range->scheduler, &group, sum_range, &left);
+    sum_range(&right);
+    Scheduler_wait(range->scheduler, &group);
+
+    range->sum = left.sum + right.sum;
+}
+
+char *test_fork_join_SC()
+{
+    Scheduler *scheduler = Scheduler_create(2);
+    mu_assert(scheduler != NULL && scheduler->worker_count == 2, "failed to create scheduler.");
+    mu_assert(Scheduler_worker_index(scheduler) == -1, "caller thought it's a worker.");
+
+    SumRange range = { scheduler, 0, 100000, 0 };
+    TaskGroup group;
+    TaskGroup_init(&group);
+    rc = Scheduler_spawn(scheduler, &group, sum_range, &range);
+    mu_assert(rc != CERB_ERR, "spawn failed.");
+    rc = Scheduler_wait(scheduler, &group);
+    mu_assert(rc != CERB_ERR && range.sum == (intptr_t) 99999 * 100000 / 2, "fork join sum is wrong.");
+
+    rc = Scheduler_destroy(&scheduler);
+    mu_assert(rc != CERB_ERR && scheduler == NULL, "failed to destroy scheduler.");
+    mu_assert(Scheduler_destroy(&scheduler) == CERB_ERR, "destroyed scheduler twice.");
+
+    return NULL;
+}
+
+// test lock free stack
+
+#define LFSTACK_THREADS 4
+#define LFSTACK_PUSHES 20000
+
+LFStack *shared_stack = NULL;
+
+// push a run of own values and pop half as many back, so pushes and pops keep colliding
+void *lfstack_worker(void *arg)
+{
+    intptr_t *sum = arg;
+    intptr_t first = *sum, i = 0;
+    *sum = 0;
+
+    for (i = first; i < first + LFSTACK_PUSHES; i++) {
+        while (LFStack_push(shared_stack, (void *) i) == CERB_ERR) sched_yield();
+        if (i & 1) *sum += (intptr_t) LFStack_pop(shared_stack);
+    }
+
+    return NULL;
+}
+
+char *test_concurrent_LF()
+{
+    shared_stack = LFStack_create();
+    mu_assert(shared_stack != NULL && LFStack_is_empty(shared_stack), "failed to create stack.");
+
+    mu_assert(LFStack_pop(shared_stack) == NULL, "empty stack popped something.");
+    mu_assert(LFStack_push(shared_stack, NULL) == CERB_ERR, "pushed NULL.");
+    LFStack_push(shared_stack, test1);
+    LFStack_push(shared_stack, test2);
+    mu_assert(LFStack_pop(shared_stack) == test2 && LFStack_pop(shared_stack) == test1, "pop went in wrong order.");
+
+    pthread_t threads[LFSTACK_THREADS];
+    intptr_t sums[LFSTACK_THREADS];
+    int i = 0;
+    for (i = 0; i < LFSTACK_THREADS; i++) {
+        sums[i] = 1 + (intptr_t) i * LFSTACK_PUSHES;
+        mu_assert(pthread_create(&threads[i], NULL, lfstack_worker, &sums[i]) == 0, "failed to start thread.");
+    }
+    for (i = 0; i < LFSTACK_THREADS; i++) pthread_join(threads[i], NULL);
+
+    intptr_t total = 0, n = (intptr_t) LFSTACK_THREADS * LFSTACK_PUSHES;
+    void *element = NULL;
+    for (i = 0; i < LFSTACK_THREADS; i++) total += sums[i];
+    while ((element = LFStack_pop(shared_stack)) != NULL) total += (intptr_t) element;
+    mu_assert(total == n * (n + 1) / 2, "elements got lost or duplicated.");
+
+    rc = LFStack_destroy(&shared_stack);
+    mu_assert(rc != CERB_ERR && shared_stack == NULL, "failed to destroy stack.");
+    mu_assert(LFStack_destroy(&shared_stack) == CERB_ERR, "destroyed stack twice.");
+
+    return NULL;
+}
+
+// test node pool
+
+char *test_slabs_NP()
+{
+    NodePool *pool = NodePool_create(sizeof(DLinkedNode), 4);
+    mu_assert(pool != NULL && pool->users == 1, "failed to create pool.");
+
+    DLinked *list1 = DLinked_create_pooled(NULL, pool);
+    DLinked *list2 = DLinked_create_pooled(NULL, pool);
+    mu_assert(list1 != NULL && list2 != NULL && pool->users == 3, "lists didn't retain pool.");
+    NodePool_release(&pool);
+    pool = list1->pool;
+
+    char *values[] = { test1, test2, test3, test4, test5 };
+    int i = 0;
+    for (i = 0; i < 5; i++) {
+        DLinked_push(list1, values[i]);
+        DLinked_unshift(list2, values[i]);
+    }
+    mu_assert(pool->slab_count == 3, "pool didn't carve nodes out of slabs.");
+
+    // a freed node is the next one handed out
+    DLinkedNode *last = list1->last;
+    DLinked_pop(list1);
+    DLinked_push(list1, test5);
+    mu_assert(list1->last == last && pool->slab_count == 3, "pool didn't recycle node.");
+
+    rc = DLinked_join(&list1, &list2);
+    mu_assert(rc != CERB_ERR && list1->count == 10 && pool->users == 1, "join failed.");
+    list2 = DLinked_split(&list1, list1->first->next, NULL);
+    mu_assert(list2 != NULL && list2->pool == pool && pool->users == 2, "split list didn't share pool.");
+
+    DLinked *other = DLinked_create(NULL);
+    DLinked_push(other, test1);
+    mu_assert(DLinked_join(&list1, &other) == CERB_ERR, "joined lists with different pools.");
+    DLinked_destroy(&other);
+
+    rc = DLinked_destroy(&list2);
+    mu_assert(rc != CERB_ERR && pool->users == 1 && pool->free_nodes != NULL, "destroy didn't give nodes back.");
+    rc = DLinked_destroy(&list1);
+    mu_assert(rc != CERB_ERR && list1 == NULL, "failed to destroy last list using pool.");
+
+    SLinked *slist = SLinked_create_pooled(NULL, NULL);
+    mu_assert(slist != NULL && slist->pool != NULL, "failed to create list with own pool.");
+    SLinked_push_many(slist, (void **) values, 5);
+    mu_assert(SLinked_shift(slist) == test1 && slist->count == 4, "shift failed.");
+    rc = SLinked_free_list(&slist);
+    mu_assert(rc != CERB_ERR && slist == NULL, "failed to free list.");
+
+    return NULL;
+}
+
+// test intrusive list
+
+typedef struct Timer {
+    int deadline;
+    IListLink link;
+} Timer;
+
+int cmp_deadline(const void *deadline, const void *timer)
+{
+    return *(const int *) deadline - ((const Timer *) timer)->deadline;
+}
+
+char *test_timers_IL()
+{
+    Timer timers[6] = { { 0, { NULL, NULL } } };
+    IList embedded; // lists don't have to be on the heap
+    IList *list = &embedded;
+    IList_init(list);
+
+    int i = 0;
+    for (i = 0; i < 6; i++) {
+        timers[i].deadline = i * 10;
+        rc = i % 2 ? IList_push(list, &timers[i].link) : IList_unshift(list, &timers[i].link);
+        mu_assert(rc != CERB_ERR, "failed to link timer.");
+    }
+    // 40 20 0 10 30 50
+    mu_assert(list->count == 6 && IList_entry(list->first, Timer, link)->deadline == 40, "links went to wrong ends.");
+    mu_assert(IList_push(list, &timers[3].link) == CERB_ERR, "linked a link twice.");
+
+    int sum = 0;
+    IList_iter_entry (list, first, next, Timer, link, timer) {
+        sum += timer->deadline;
+        if (timer->deadline >= 30) IList_remove(list, &timer->link);
+    }
+    mu_assert(sum == 150 && list->count == 3, "removing while iterating failed.");
+
+    int wanted = 10;
+    IList_search (list, last, prev, Timer, link, cmp_deadline, &wanted, found);
+    mu_assert(found == &timers[1], "search found wrong timer.");
+
+    rc = IList_insert_before(list, &timers[1].link, &timers[5].link);
+    mu_assert(rc != CERB_ERR && timers[5].link.next == &timers[1].link, "insert_before failed.");
+
+    IList *other = IList_create();
+    rc = IList_split(list, &timers[0].link, NULL, other);
+    mu_assert(rc != CERB_ERR && other->count == 3 && list->count == 1, "split failed.");
+    mu_assert(IList_pop(other) == &timers[1].link && IList_pop(other)->next == NULL, "pop failed.");
+
+    rc = IList_join(list, other);
+    mu_assert(rc != CERB_ERR && list->count == 2 && other->count == 0, "join failed.");
+    mu_assert(IList_shift(list) == &timers[2].link && IList_shift(list) == &timers[0].link, "shift failed.");
+    mu_assert(IList_shift(list) == NULL && list->last == NULL, "list didn't get empty.");
+
+    rc = IList_destroy(&other);
+    mu_assert(rc != CERB_ERR && other == NULL, "failed to destroy list->");
+
+    return NULL;
+}
+
+// test unrolled list
+
+char *test_unrolled_UL()
+{
+    UList *list = UList_create();
+    mu_assert(list != NULL, "failed to create list.");
+
+    intptr_t i = 0;
+    for (i = 1; i <= 100; i++) {
+        rc = i % 2 ? UList_push(list, (void *) i) : UList_unshift(list, (void *) i);
+        mu_assert(rc != CERB_ERR, "failed to add element.");
+    }
+    mu_assert(list->count == 100 && list->node_count <= 100 / ULIST_NODE_ITEMS + 2, "nodes aren't packed.");
+    mu_assert(UList_shift(list) == (void *) 100 && UList_pop(list) == (void *) 99, "ends came out wrong.");
+
+    // remove every even number in one pass, iterator moves on by itself
+    UListIter at = UList_begin(list);
+    while (UList_iter_valid(at)) {
+        if ((intptr_t) UList_iter_data(at) % 2 == 0) {
+            UList_remove(list, &at);
+        } else {
+            UList_next(at);
+        }
+    }
+    mu_assert(list->count == 49, "remove by iterator failed.");
+
+    at = UList_begin(list);
+    UList_next(at);
+    rc = UList_insert(list, &at, test1);
+    mu_assert(rc != CERB_ERR && UList_iter_data(at) == test1 && list->first->items[1].data == test1, "insert failed.");
+
+    UList_search (list, cmp_intptr, (void *) 1, found);
+    mu_assert(found != NULL && found->data == (void *) 1, "search didn't find element.");
+
+    UList *tail = UList_split(list, at);
+    mu_assert(tail != NULL && tail->count == 49 && list->count == 1, "split failed.");
+    rc = UList_join(&list, &tail);
+    mu_assert(rc != CERB_ERR && list->count == 50 && tail == NULL, "join failed.");
+    mu_assert(list->first->items[1].data == test1 && list->first->count > 2, "join didn't merge the seam.");
+
+    rc = UList_destroy(&list);
+    mu_assert(rc != CERB_ERR && list == NULL, "failed to destroy list.");
+
+    return NULL;
+}
+
+// test skip list
+
+char *test_ordered_SK()
+{
+    SkipList *list = SkipList_create(cmp_keyed);
+    mu_assert(list != NULL && list->level == 1, "failed to create list.");
+
+    // keyed[] still holds keys ( i * 37 ) % 23 from the list sort tests
+    int i = 0;
+    for (i = 0; i < 200; i++) {
+        mu_assert(SkipList_insert(list, &keyed[i]) != NULL, "insert failed.");
+    }
+    mu_assert(list->count == 200 && list->level > 1, "list didn't grow levels.");
+
+    Keyed *prev = NULL;
+    SkipList_iter (list, cur) {
+        Keyed *k = cur->data;
+        mu_assert(!prev || prev->key < k->key || (prev->key == k->key && prev->seq < k->seq), "list isn't ordered stably.");
+        prev = k;
+    }
+
+    Keyed low = { 5, 0 }, high = { 8, 0 };
+    uint32_t rank = SkipList_rank(list, &low);
+    int in_range = 0;
+    SkipList_range (list, &low, &high, node) {
+        mu_assert(SkipList_at(list, rank + in_range) == node, "rank and position don't match.");
+        in_range++;
+    }
+    mu_assert(rank + in_range == SkipList_rank(list, &high) && in_range > 0, "range scan missed elements.");
+
+    SkipListNode *found = SkipList_find(list, &low);
+    mu_assert(found != NULL && ((Keyed *) found->data)->key == 5, "find failed.");
+    Keyed *first_five = found->data;
+    Keyed *second_five = SkipList_next(found)->data;
+    mu_assert(second_five->key == 5, "equal elements aren't next to each other.");
+
+    mu_assert(SkipList_remove_node(list, SkipList_next(found)) == second_five, "remove_node failed.");
+    mu_assert(SkipList_remove(list, &low) == first_five && list->count == 198, "remove failed.");
+    mu_assert(SkipList_at(list, rank)->data != first_five, "removed element is still there.");
+
+    rc = SkipList_destroy(&list);
+    mu_assert(rc != CERB_ERR && list == NULL, "failed to destroy list.");
+
+    return NULL;
+}
+
 // test hashmap
 
 char *test_create_HM()
@@ -314,19 +1605,63 @@ char *all_tests()
     mu_run_test(test_push_SL);
     mu_run_test(test_pop_SL);
     mu_run_test(test_remove_SL);
+    mu_run_test(test_tail_SL);
+    mu_run_test(test_sort_SL);
     mu_run_test(test_free_list_SL);
 
     mu_run_test(test_create_DL);
     mu_run_test(test_push_DL);
     mu_run_test(test_pop_DL);
     mu_run_test(test_remove_DL);
+    mu_run_test(test_splice_DL);
+    mu_run_test(test_sort_DL);
     mu_run_test(test_free_list_DL);
 
     mu_run_test(test_create_DA);
     mu_run_test(test_push_DA);
     mu_run_test(test_pop_DA);
+    mu_run_test(test_search_index_DA);
+    mu_run_test(test_scan_DA);
+    mu_run_test(test_range_DA);
+    mu_run_test(test_small_DA);
+    mu_run_test(test_huge_DA);
+    mu_run_test(test_parallel_DA);
+    mu_run_test(test_setops_DA);
     mu_run_test(test_free_array_DA);
 
+    mu_run_test(test_concurrent_push_SA);
+
+    mu_run_test(test_persist_MA);
+
+    mu_run_test(test_snapshot_CA);
+
+    mu_run_test(test_pack_PA);
+
+    mu_run_test(test_columns_CS);
+
+    mu_run_test(test_order_PQ);
+
+    mu_run_test(test_push_pop_ST);
+
+    mu_run_test(test_ring_QU);
+
+    mu_run_test(test_handoff_MQ);
+
+    mu_run_test(test_pipeline_SQ);
+
+    mu_run_test(test_deque_WS);
+    mu_run_test(test_fork_join_SC);
+
+    mu_run_test(test_concurrent_LF);
+
+    mu_run_test(test_slabs_NP);
+
+    mu_run_test(test_timers_IL);
+
+    mu_run_test(test_unrolled_UL);
+
+    mu_run_test(test_ordered_SK);
+
     mu_run_test(test_create_HM);
     mu_run_test(test_set_HM);
     mu_run_test(test_delete_HM);